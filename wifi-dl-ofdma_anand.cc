@@ -31,1275 +31,8328 @@
 #include "ns3/sta-wifi-mac.h"
 #include "ns3/ap-wifi-mac.h"
 #include "ns3/qos-txop.h"
+#include "ns3/ofdma-manager.h"
+#include "ns3/he-ru.h"
+#include "ns3/mpdu-aggregator.h"
+#include "ns3/wifi-ack-policy-selector.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/arp-cache.h"
 #include "ns3/application-container.h"
 #include "ns3/packet-sink-helper.h"
 #include "ns3/packet-sink.h"
 #include "ns3/on-off-helper.h"
 #include "ns3/v4ping-helper.h"
 #include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/channel-list.h"
 #include "ns3/wifi-mac-queue.h"
 #include "ns3/mac-low.h"
 #include "ns3/wifi-psdu.h"
 #include "ns3/ctrl-headers.h"
 #include "ns3/traffic-control-helper.h"
+#include "ns3/tag.h"
+#include "ns3/rng-seed-manager.h"
 
 #include "ns3/netanim-module.h"
 #include "ns3/flow-monitor.h"
 #include "ns3/flow-monitor-helper.h"
+#include "ns3/ipv4-flow-classifier.h"
 #include "ns3/bulk-send-helper.h" 
+#include "ns3/udp-socket-factory.h"
+#include "ns3/tcp-socket-factory.h"
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <cmath>
 #include <iomanip>
 #include <sstream>
 #include <numeric>
+#include <algorithm>
 #include <chrono>
+#include <fstream>
+#include <set>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/file.h>
+#include <sys/resource.h>
+#include <sys/mman.h>
+#include <cctype>
+#include <limits>
+#include <deque>
 
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("WifiDlOfdmaExample");
 
 /**
- * \brief Example to test DL OFDMA
- *
- * Usage: ./waf --run "wifi-dl-ofdma [options]" > results.log
- *
- * To extract the list of space-separated throughput values:
- *
- * grep -A 2 Throughput results.log | grep STA_ | sed 's/STA_[0-9]*: //g'
+ * \brief Byte tag carrying the time a packet was sent by the client application
  *
- * Similarly, it is possible to extract the list of per-station TX failures
- * (grep -A 2 failures...) and expired MSDUs (grep -A 2 Expired...)
+ * The tag is added to the packets sent by the client applications and read back by
+ * the packet sinks, so that the application-to-application latency can be measured
+ * without keeping track of the packets in flight. A byte tag is used because it
+ * survives A-MSDU aggregation and TCP segmentation. Since the data of an application
+ * write may be split across TCP segments, the tag also carries an identifier and the
+ * size of the write, so that a single latency sample is taken when the last byte of
+ * the write is received.
  */
-class WifiDlOfdmaExample
+class AppTxTimeTag : public Tag
 {
 public:
   /**
-   * Create an example instance.
-   */
-  WifiDlOfdmaExample ();
-  /**
-   * Parse the options provided through command line.
-   */
-  void Config (int argc, char *argv[]);
-  /**
-   * Setup nodes, devices and internet stacks.
+   * \brief Get the type ID.
+   * \return the object TypeId
    */
-  void Setup (void);
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer i) const;
+  virtual void Deserialize (TagBuffer i);
+  virtual void Print (std::ostream &os) const;
+
   /**
-   * Run simulation and print results.
+   * Set the time the packet was sent by the application.
+   * \param txTime the time the packet was sent by the application
    */
-  void Run (void);
+  void SetTxTime (Time txTime);
   /**
-   * Make the current station associate with the AP.
+   * \return the time the packet was sent by the application
    */
-  void StartAssociation (void);
+  Time GetTxTime (void) const;
   /**
-   * Make the AP establish a BA agreement with the current station.
+   * Set the identifier and the size of the application write.
+   * \param writeId the identifier of the application write
+   * \param writeSize the size of the application write
    */
-  void EstablishBaAgreement (Mac48Address bssid);
+  void SetWrite (uint64_t writeId, uint32_t writeSize);
   /**
-   * Start an OnOff client application.
+   * \return the identifier of the application write
    */
-  void StartOnOffClient (OnOffHelper client);         //jaishreeram from StartClient to StartOnOffClient
+  uint64_t GetWriteId (void) const;
   /**
-   * Start a BulkSend client application.
+   * \return the size of the application write
    */
-  void StartBulkSendClient (BulkSendHelper client);   //jaishreeram
+  uint32_t GetWriteSize (void) const;
+
+private:
+  Time m_txTime;        // time the packet was sent by the application
+  uint64_t m_writeId;   // identifier of the application write
+  uint32_t m_writeSize; // size of the application write
+};
+
+NS_OBJECT_ENSURE_REGISTERED (AppTxTimeTag);
+
+TypeId
+AppTxTimeTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::AppTxTimeTag")
+    .SetParent<Tag> ()
+    .AddConstructor<AppTxTimeTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+AppTxTimeTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+AppTxTimeTag::GetSerializedSize (void) const
+{
+  return 20;
+}
+
+void
+AppTxTimeTag::Serialize (TagBuffer i) const
+{
+  i.WriteU64 (m_txTime.GetTimeStep ());
+  i.WriteU64 (m_writeId);
+  i.WriteU32 (m_writeSize);
+}
+
+void
+AppTxTimeTag::Deserialize (TagBuffer i)
+{
+  m_txTime = TimeStep (i.ReadU64 ());
+  m_writeId = i.ReadU64 ();
+  m_writeSize = i.ReadU32 ();
+}
+
+void
+AppTxTimeTag::Print (std::ostream &os) const
+{
+  os << "txTime=" << m_txTime << " writeId=" << m_writeId << " writeSize=" << m_writeSize;
+}
+
+void
+AppTxTimeTag::SetTxTime (Time txTime)
+{
+  m_txTime = txTime;
+}
+
+Time
+AppTxTimeTag::GetTxTime (void) const
+{
+  return m_txTime;
+}
+
+void
+AppTxTimeTag::SetWrite (uint64_t writeId, uint32_t writeSize)
+{
+  m_writeId = writeId;
+  m_writeSize = writeSize;
+}
+
+uint64_t
+AppTxTimeTag::GetWriteId (void) const
+{
+  return m_writeId;
+}
+
+uint32_t
+AppTxTimeTag::GetWriteSize (void) const
+{
+  return m_writeSize;
+}
+
+/**
+ * \brief Constant-memory streaming histogram of latency samples
+ *
+ * Samples are counted in log-linear buckets (as in HDR histograms): every power
+ * of two interval of nanoseconds is split into 2^SUB_BUCKET_BITS equal buckets,
+ * hence percentiles are reported with a relative error below 2^-SUB_BUCKET_BITS.
+ * The number of buckets is fixed and recording a sample takes constant time, so
+ * the memory footprint does not depend on the duration of the simulation.
+ */
+class LatencyHistogram
+{
+public:
+  LatencyHistogram ();
   /**
-   * Start generating traffic.
+   * Record a latency sample.
+   * \param latency the latency sample
    */
-  void StartTraffic (void);
+  void Add (Time latency);
   /**
-   * Start collecting statistics.
+   * Add the samples recorded by the given histogram to this histogram.
+   * \param other the given histogram
    */
-  void StartStatistics (void);
+  void Merge (const LatencyHistogram& other);
   /**
-   * Stop collecting statistics.
+   * \return the number of recorded samples
    */
-  void StopStatistics (void);
+  uint64_t GetCount (void) const;
   /**
-   * Report that an MPDU was not correctly received.
+   * \return the average of the recorded samples
    */
-  void NotifyTxFailed (const WifiMacHeader& hdr);
+  Time GetMean (void) const;
   /**
-   * Report that the lifetime of an MSDU expired.
+   * \return the maximum recorded sample
    */
-  void NotifyMsduExpired (Ptr<const WifiMacQueueItem> item);
+  Time GetMax (void) const;
   /**
-   * Report that an MSDU was dequeued from the EDCA queue.
+   * \param percentile the requested percentile (between 0 and 100)
+   * \return the (approximate) value below which the given percentage of samples fall
    */
-  void NotifyMsduDequeuedFromEdcaQueue (Ptr<const WifiMacQueueItem> item);
+  Time GetPercentile (double percentile) const;
+
+private:
   /**
-   * Report that PSDUs were forwarded down to the PHY.
+   * \param ns a latency sample in nanoseconds
+   * \return the index of the bucket counting the given sample
    */
-  void NotifyPsduForwardedDown (WifiPsduMap psduMap, WifiTxVector txVector);
+  static std::size_t GetIndex (uint64_t ns);
   /**
-   * Report that an MPDU was not correctly received.
+   * \param index the index of a bucket
+   * \return the value (in nanoseconds) in the middle of the given bucket
    */
-  void TxopDuration (Time startTime, Time duration);
+  static uint64_t GetMidpoint (std::size_t index);
+
+  static const uint8_t SUB_BUCKET_BITS = 6;     // 64 buckets per power of two
+  static const uint8_t MAX_BITS = 40;           // samples up to about 1100 seconds
+  static const std::size_t N_BUCKETS = (MAX_BITS - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS;
+
+  std::vector<uint64_t> m_counts;  // number of samples per bucket
+  uint64_t m_count;                // total number of samples
+  double m_sum;                    // sum of the samples (nanoseconds)
+  uint64_t m_max;                  // maximum sample (nanoseconds)
+};
+
+LatencyHistogram::LatencyHistogram ()
+  : m_counts (N_BUCKETS, 0),
+    m_count (0),
+    m_sum (0.0),
+    m_max (0)
+{
+}
+
+std::size_t
+LatencyHistogram::GetIndex (uint64_t ns)
+{
+  if (ns < (1u << SUB_BUCKET_BITS))
+    {
+      // one bucket per nanosecond
+      return ns;
+    }
+  uint8_t msb = 63 - __builtin_clzll (ns);
+  if (msb >= MAX_BITS)
+    {
+      return N_BUCKETS - 1;
+    }
+  uint8_t shift = msb - SUB_BUCKET_BITS;
+  // the first (1 << SUB_BUCKET_BITS) buckets are taken by the values below that threshold
+  return ((shift + 1) << SUB_BUCKET_BITS) + (ns >> shift) - (1u << SUB_BUCKET_BITS);
+}
+
+uint64_t
+LatencyHistogram::GetMidpoint (std::size_t index)
+{
+  if (index < (1u << SUB_BUCKET_BITS))
+    {
+      return index;
+    }
+  uint8_t shift = (index >> SUB_BUCKET_BITS) - 1;
+  uint64_t lowest = (static_cast<uint64_t> (index & ((1u << SUB_BUCKET_BITS) - 1)) + (1u << SUB_BUCKET_BITS)) << shift;
+  return lowest + ((1ull << shift) >> 1);
+}
+
+void
+LatencyHistogram::Add (Time latency)
+{
+  uint64_t ns = (latency.IsStrictlyPositive () ? latency.GetNanoSeconds () : 0);
+  m_counts[GetIndex (ns)]++;
+  m_count++;
+  m_sum += ns;
+  m_max = std::max (m_max, ns);
+}
+
+void
+LatencyHistogram::Merge (const LatencyHistogram& other)
+{
+  for (std::size_t i = 0; i < N_BUCKETS; i++)
+    {
+      m_counts[i] += other.m_counts[i];
+    }
+  m_count += other.m_count;
+  m_sum += other.m_sum;
+  m_max = std::max (m_max, other.m_max);
+}
+
+uint64_t
+LatencyHistogram::GetCount (void) const
+{
+  return m_count;
+}
+
+Time
+LatencyHistogram::GetMean (void) const
+{
+  return (m_count > 0 ? NanoSeconds (m_sum / m_count) : Seconds (0));
+}
+
+Time
+LatencyHistogram::GetMax (void) const
+{
+  return NanoSeconds (m_max);
+}
+
+Time
+LatencyHistogram::GetPercentile (double percentile) const
+{
+  if (m_count == 0)
+    {
+      return Seconds (0);
+    }
+  // rank (starting at 1) of the sample corresponding to the given percentile
+  uint64_t rank = std::max<uint64_t> (1, std::ceil (percentile / 100 * m_count));
+  uint64_t cumulative = 0;
+  for (std::size_t i = 0; i < N_BUCKETS; i++)
+    {
+      cumulative += m_counts[i];
+      if (cumulative >= rank)
+        {
+          return NanoSeconds (std::min (GetMidpoint (i), m_max));
+        }
+    }
+  return NanoSeconds (m_max);
+}
+
+
+/**
+ * \brief Propagation loss model serving the link gains from a precomputed table
+ *
+ * If no node moves, the gain of every link is constant. This model computes the
+ * gain of all the links between the given nodes once, by means of an underlying
+ * propagation loss model, and then returns the gains stored in a table indexed by
+ * the mobility models of the transmitter and receiver nodes (which are mapped to
+ * table indices by a hash lookup, so that no aggregate lookup is needed to find the
+ * nodes they belong to). The spectrum channel therefore
+ * no longer computes distances and path losses for every receiver of every PPDU.
+ * Links involving nodes that are not in the table are computed by the underlying
+ * model.
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+public:
   /**
-   * Report that the application has created and sent a new packet.
+   * \brief Get the type ID.
+   * \return the object TypeId
    */
-  void NotifyApplicationTx (std::string context, Ptr<const Packet>);
+  static TypeId GetTypeId (void);
+  CachedPropagationLossModel ();
+
   /**
-   * Report that the application has received a new packet.
+   * Set the propagation loss model used to compute the link gains.
+   * \param model the underlying propagation loss model
    */
-  void NotifyApplicationRx (std::string context, Ptr<const Packet> p);
+  void SetUnderlyingModel (Ptr<PropagationLossModel> model);
   /**
-   * Parse context strings of the form "/NodeList/x/DeviceList/y/" to extract the NodeId
+   * Compute the gains of all the links between the given nodes. All the nodes must
+   * have a ConstantPositionMobilityModel.
+   * \param nodes the given nodes
    */
-  uint32_t ContextToNodeId (const std::string & context);
+  void Precompute (NodeContainer nodes);
 
 private:
-  uint32_t m_payloadSize;   // bytes
-  double m_simulationTime;  // seconds
-  uint16_t m_nStations;     // not including AP
-  double m_radius;          // meters
-  bool m_enableDlOfdma;
-  bool m_forceDlOfdma;
-  bool m_enableUlOfdma;
-  uint32_t m_ulPsduSize;
-  uint16_t m_channelWidth;  // channel bandwidth
-  uint8_t m_channelNumber;
-  uint16_t m_channelCenterFrequency;
-  uint16_t m_guardInterval; // GI in nanoseconds
-  uint8_t m_maxNRus;        // max number of RUs per MU PPDU
-  uint32_t m_mcs;           // MCS value
-  uint16_t m_maxAmsduSize;  // maximum A-MSDU size
-  uint32_t m_maxAmpduSize;  // maximum A-MSDU size
-  double m_txopLimit;       // microseconds
-  uint32_t m_macQueueSize;  // packets
-  uint32_t m_msduLifetime;  // milliseconds
-  bool m_enableRts;
-  double m_dataRate;        // Mb/s
-  uint16_t m_dlAckSeqType;
-  bool m_continueTxop;
-  uint16_t m_baBufferSize;
-  std::string m_transport;
-  std::string m_queueDisc;
-  bool m_enablePcap;
-  double m_warmup;          // duration of the warmup period (seconds)
-  std::size_t m_currentSta; // index of the current station
-  Ssid m_ssid;
-  NodeContainer m_apNodes;
-  NodeContainer m_staNodes;
-  NetDeviceContainer m_staDevices;
-  NetDeviceContainer m_apDevices;
-  Ipv4InterfaceContainer m_staInterfaces;
-  ApplicationContainer m_sinkApps;
-  ApplicationContainer m_sinkApps_bulk;
-  ApplicationContainer m_clientApps;
-  ApplicationContainer m_clientApps_bulk;   //added this jaishreeram
-  uint16_t m_port;
-  uint16_t m_port_bulk; //port for bulksendapp jaishreeram
-  Time m_maxTxop;
-  std::vector<uint64_t> m_rxStart, m_rxStop;
-  double m_minAmpduRatio;
-  double m_maxAmpduRatio;
-  double m_avgAmpduRatio;
-  uint64_t m_nAmpduRatioSamples;
-  Time m_lastTxTime;
-  double m_minHolDelay;     // milliseconds
-  double m_maxHolDelay;     // milliseconds
-  double m_avgHolDelay;     // milliseconds
-  uint64_t m_nHolDelaySamples;
-  std::map <uint64_t /* uid */, Time /* start */> m_appPacketTxMap;
-  std::map <uint32_t /* nodeId */, std::vector<Time>  /* array of latencies */> m_appLatencyMap;
-  bool m_verbose;
-  uint64_t m_nBasicTriggerFramesSent;
-  uint64_t m_nFailedTriggerFrames;  // no station responded
-  double m_minLengthRatio;
-  double m_maxLenghtRatio;
-  double m_avgLengthRatio;
-  Time m_tfUlLength;                // TX duration coded in UL Length subfield of Trigger Frame
-  Time m_overallTimeGrantedByTf;    // m_tfUlLength times the number of addressed stations
-  Time m_responsesToLastTfDuration; // sum of the durations of the HE TB PPDUs in response to last TF
-  Ipv4InterfaceContainer ApInterface;  //Interface for ap // jaishreeram
-  struct DlStats
-  {
-    uint64_t failed {0};
-    uint64_t expired {0};
-    uint32_t minAmpduSize {0};
-    uint32_t maxAmpduSize {0};
-    uint64_t nAmpdus {0};
-    double minAmpduRatio {0.0};
-    double maxAmpduRatio {0.0};
-    double avgAmpduRatio {0.0};
-    uint64_t nAmpduRatioSamples {0};
-    Time lastTxTime {Seconds (0)};
-    double minHolDelay {0.0};
-    double maxHolDelay {0.0};
-    double avgHolDelay {0.0};
-    uint64_t nHolDelaySamples {0};
-  };
-  std::map<Mac48Address, DlStats> m_dlStats;
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
 
-  struct UlStats
-  {
-    double minLengthRatio {0.0};
-    double maxLenghtRatio {0.0};
-    double avgLengthRatio {0.0};
-    uint64_t nLengthRatioSamples {0};  // count of HE TB PPDUs sent
-    uint64_t nSolicitingTriggerFrames {0};
-  };
-  std::map<Mac48Address, UlStats> m_ulStats;
+  Ptr<PropagationLossModel> m_model;  // underlying propagation loss model
+  std::unordered_map<const MobilityModel *, uint32_t> m_index;  // table index of the mobility model of each node
+  std::vector<double> m_gains;        // gain (dB) of each link, indexed by (tx index, rx index)
+  uint32_t m_nNodes;                  // number of rows (and columns) of the table
 };
 
-WifiDlOfdmaExample::WifiDlOfdmaExample ()
-  : m_payloadSize (160),    //jaishreeram changed it to 160 to simulate voice calls
-    m_simulationTime (2),
-    m_nStations (10),   // by default it was 4 jaishreeram
-    m_radius (10),
-    m_enableDlOfdma (true),
-    m_forceDlOfdma (true),
-    m_enableUlOfdma (false),
-    m_ulPsduSize (0),
-    m_channelWidth (20),
-    m_channelNumber (36),
-    m_channelCenterFrequency (0),
-    m_guardInterval (3200),
-    m_maxNRus (4),
-    m_mcs (0),
-    m_maxAmsduSize (7500),
-    m_maxAmpduSize (8388607u),
-    m_txopLimit (5440),
-    m_macQueueSize (0),  // invalid value
-    m_msduLifetime (0),  // invalid value
-    m_enableRts (false),
-    m_dataRate (0),      // invalid value //jaishreeram made it 10kbps for simulating voice calls
-    m_dlAckSeqType (1),
-    m_continueTxop (false),
-    m_baBufferSize (64),
-    m_transport ("Udp"),
-    m_queueDisc ("default"),
-    m_enablePcap (false),
-    m_warmup (1.0),
-    m_currentSta (0),
-    m_ssid (Ssid ("network-A")),
-    m_port (50000), //jaishreeram changed from 7000 to 50000
-    m_port_bulk(50001), //jaishreeram port for bulksend
-    m_maxTxop (Seconds (0)),
-    m_minAmpduRatio (0.0),
-    m_maxAmpduRatio (0.0),
-    m_avgAmpduRatio (0.0),
-    m_nAmpduRatioSamples (0),
-    m_lastTxTime (Seconds (0)),
-    m_minHolDelay (0.0),
-    m_maxHolDelay (0.0),
-    m_avgHolDelay (0.0),
-    m_nHolDelaySamples (0),
-    m_verbose (false),
-    m_nBasicTriggerFramesSent (0),
-    m_nFailedTriggerFrames (0),
-    m_minLengthRatio (0.0),
-    m_maxLenghtRatio (0.0),
-    m_avgLengthRatio (0.0),
-    m_tfUlLength (Seconds (0)),
-    m_overallTimeGrantedByTf (Seconds (0)),
-    m_responsesToLastTfDuration (Seconds (0))
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationLossModel);
+
+TypeId
+CachedPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .AddConstructor<CachedPropagationLossModel> ()
+  ;
+  return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel ()
+  : m_nNodes (0)
 {
 }
 
 void
-WifiDlOfdmaExample::Config (int argc, char *argv[])
+CachedPropagationLossModel::SetUnderlyingModel (Ptr<PropagationLossModel> model)
 {
-  NS_LOG_FUNCTION (this);
+  m_model = model;
+}
 
-  CommandLine cmd;
-  cmd.AddValue ("payloadSize", "Payload size in bytes", m_payloadSize);
-  cmd.AddValue ("simulationTime", "Simulation time in seconds", m_simulationTime);
-  cmd.AddValue ("nStations", "Number of non-AP stations", m_nStations);
-  cmd.AddValue ("radius", "Radius of the disc centered in the AP and containing all the non-AP STAs", m_radius);
-  cmd.AddValue ("enableDlOfdma", "Enable/disable DL OFDMA", m_enableDlOfdma);
-  cmd.AddValue ("forceDlOfdma", "The RR scheduler always returns DL OFDMA", m_forceDlOfdma);
-  cmd.AddValue ("dlAckType", "Ack sequence type for DL OFDMA (1-3)", m_dlAckSeqType);
-  cmd.AddValue ("enableUlOfdma", "The RR scheduler returns UL OFDMA after DL OFDMA", m_enableUlOfdma);
-  cmd.AddValue ("ulPsduSize", "Max size in bytes of HE TB PPDUs", m_ulPsduSize);
-  cmd.AddValue ("channelWidth", "Channel bandwidth (20, 40, 80, 160)", m_channelWidth);
-  cmd.AddValue ("guardInterval", "Guard Interval (800, 1600, 3200)", m_guardInterval);
-  cmd.AddValue ("maxRus", "Maximum number of RUs allocated per DL MU PPDU", m_maxNRus);
-  cmd.AddValue ("mcs", "The constant MCS value to transmit HE PPDUs", m_mcs);
-  cmd.AddValue ("maxAmsduSize", "Maximum A-MSDU size", m_maxAmsduSize);
-  cmd.AddValue ("maxAmpduSize", "Maximum A-MPDU size", m_maxAmpduSize);
-  cmd.AddValue ("txopLimit", "TXOP duration in microseconds", m_txopLimit);
-  cmd.AddValue ("queueSize", "Maximum size of a WifiMacQueue (packets)", m_macQueueSize);
-  cmd.AddValue ("msduLifetime", "Maximum MSDU lifetime in milliseconds", m_msduLifetime);
-  cmd.AddValue ("continueTxop", "Continue TXOP if no SU response after MU PPDU", m_continueTxop);
-  cmd.AddValue ("baBufferSize", "Block Ack buffer size", m_baBufferSize);
-//   cmd.AddValue ("enableRts", "Enable or disable RTS/CTS", m_enableRts);
-  cmd.AddValue ("dataRate", "Per-station data rate (Mb/s)", m_dataRate);
-  cmd.AddValue ("transport", "Transport layer protocol (Udp/Tcp)", m_transport);
-  cmd.AddValue ("queueDisc", "Queuing discipline to install on the AP (default/none)", m_queueDisc);
-  cmd.AddValue ("warmup", "Duration of the warmup period (seconds)", m_warmup);
-  cmd.AddValue ("enablePcap", "Enable PCAP trace file generation.", m_enablePcap);
-  cmd.AddValue ("verbose", "Enable/disable all Wi-Fi debug traces", m_verbose);
-  cmd.Parse (argc, argv);
-
-  uint64_t phyRate = WifiPhy::GetHeMcs (m_mcs).GetDataRate (m_channelWidth, m_guardInterval, 1);
-  // Estimate the A-MPDU size as the number of bytes transmitted at the PHY rate in
-  // an interval equal to the maximum PPDU duration
-  uint32_t ampduSize = phyRate * GetPpduMaxTime (WIFI_PREAMBLE_HE_SU).GetSeconds () / 8;  // bytes
-  // Estimate the number of MSDUs per A-MPDU as the ratio of the A-MPDU size to the MSDU size
-  uint32_t nMsdus = ampduSize / m_payloadSize;
-  // AP's EDCA queue must contain the number of MSDUs per A-MPDU times the number of stations,
-  // times a surplus coefficient
-  uint32_t queueSize = nMsdus * m_nStations * 2 /* surplus */;
-  // The MSDU lifetime must exceed the time taken by the AP to empty its EDCA queue at the PHY rate
-  uint32_t msduLifetime = queueSize * m_payloadSize * 8 * 1000. / phyRate * 2 /* surplus */;
-
-  if (m_macQueueSize == 0)
-    {
-      m_macQueueSize = queueSize;
-    }
-  if (m_msduLifetime == 0)
-    {
-      m_msduLifetime = msduLifetime;
-    }
-  if (m_dataRate == 0)
+void
+CachedPropagationLossModel::Precompute (NodeContainer nodes)
+{
+  NS_ASSERT (m_model != 0);
+  m_index.clear ();
+  std::vector<Ptr<MobilityModel> > mobility;
+  for (NodeContainer::Iterator it = nodes.Begin (); it != nodes.End (); it++)
     {
-      m_dataRate = phyRate * 1.2 /* surplus */ / 1e6 / m_nStations;
-      m_dataRate*=2;
+      Ptr<MobilityModel> model = (*it)->GetObject<ConstantPositionMobilityModel> ();
+      NS_ABORT_MSG_IF (model == 0, "Link gains can only be cached if all the nodes have a constant position");
+      m_index[PeekPointer (model)] = mobility.size ();
+      mobility.push_back (model);
     }
+  m_nNodes = mobility.size ();
+  m_gains.assign (m_nNodes * m_nNodes, 0.0);
 
-  switch (m_channelWidth)
+  for (uint32_t tx = 0; tx < m_nNodes; tx++)
     {
-    case 20:
-      m_channelNumber = 36;
-      break;
-    case 40:
-      m_channelNumber = 38;
-      break;
-    case 80:
-      m_channelNumber = 42;
-      break;
-    case 160:
-      m_channelNumber = 50;
-      break;
-    default:
-      NS_FATAL_ERROR ("Invalid channel bandwidth (must be 20, 40, 80 or 160)");
+      for (uint32_t rx = 0; rx < m_nNodes; rx++)
+        {
+          m_gains[tx * m_nNodes + rx] = m_model->CalcRxPower (0.0, mobility[tx], mobility[rx]);
+        }
     }
+}
 
-  std::cout << "Channel bw = " << m_channelWidth << " MHz" << std::endl
-            << "MCS = " << m_mcs << std::endl
-            << "Number of stations = " << m_nStations << std::endl
-            << "Data rate = " << m_dataRate << " Mbps" << std::endl
-            << "EDCA queue max size = " << m_macQueueSize << " MSDUs" << std::endl
-            << "MSDU lifetime = " << m_msduLifetime << " ms" << std::endl
-            << "BA buffer size = " << m_baBufferSize << std::endl;
-  if (m_enableDlOfdma)
-    {
-      std::cout << "Ack sequence = " << m_dlAckSeqType << std::endl;
-    }
-  else
+double
+CachedPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                           Ptr<MobilityModel> a,
+                                           Ptr<MobilityModel> b) const
+{
+  auto tx = m_index.find (PeekPointer (a));
+  auto rx = m_index.find (PeekPointer (b));
+
+  if (tx != m_index.end () && rx != m_index.end ())
     {
-      std::cout << "No OFDMA" << std::endl;
+      return txPowerDbm + m_gains[tx->second * m_nNodes + rx->second];
     }
-  std::cout << std::endl;
+  return m_model->CalcRxPower (txPowerDbm, a, b);
 }
 
-void
-WifiDlOfdmaExample::Setup (void)
+int64_t
+CachedPropagationLossModel::DoAssignStreams (int64_t stream)
 {
-  NS_LOG_FUNCTION (this);
+  return (m_model != 0 ? m_model->AssignStreams (stream) : 0);
+}
 
-  Config::SetDefault ("ns3::WifiRemoteStationManager::RtsCtsThreshold", m_enableRts ? StringValue ("0") : StringValue ("999999"));
-  Config::SetDefault ("ns3::HeConfiguration::GuardInterval", TimeValue (NanoSeconds (m_guardInterval)));
-  Config::SetDefault ("ns3::WifiPhy::GuardInterval", TimeValue (NanoSeconds (m_guardInterval)));
-  Config::SetDefault ("ns3::RegularWifiMac::ContinueTxopIfNoSuResponseAfterMuPpdu", BooleanValue (m_continueTxop));
-  Config::SetDefault ("ns3::ArpCache::AliveTimeout", TimeValue (Seconds (3600 * 24))); // ARP cache entries expire after one day
-  Config::SetDefault ("ns3::WifiMacQueue::MaxQueueSize", QueueSizeValue (QueueSize (PACKETS, m_macQueueSize)));
-  Config::SetDefault ("ns3::WifiMacQueue::MaxDelay", TimeValue (MilliSeconds (m_msduLifetime)));
-  Config::SetDefault ("ns3::HeConfiguration::MpduBufferSize", UintegerValue (m_baBufferSize));
 
-  m_staNodes.Create (m_nStations);
-  m_apNodes.Create (1);
+/**
+ * \brief Propagation delay model serving the link delays from a precomputed table
+ *
+ * This is the counterpart of CachedPropagationLossModel for propagation delays.
+ */
+class CachedPropagationDelayModel : public PropagationDelayModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  CachedPropagationDelayModel ();
 
-  Ptr<MultiModelSpectrumChannel> spectrumChannel = CreateObject<MultiModelSpectrumChannel> ();
-  Ptr<FriisPropagationLossModel> lossModel = CreateObject<FriisPropagationLossModel> ();
-  spectrumChannel->AddPropagationLossModel (lossModel);
-  Ptr<ConstantSpeedPropagationDelayModel> delayModel = CreateObject<ConstantSpeedPropagationDelayModel> ();
-  spectrumChannel->SetPropagationDelayModel (delayModel);
-  SpectrumWifiPhyHelper phy = SpectrumWifiPhyHelper::Default ();
-  phy.SetPcapDataLinkType (WifiPhyHelper::DLT_IEEE802_11_RADIO);
-  phy.SetChannel (spectrumChannel);
-  phy.Set ("ChannelNumber", UintegerValue (m_channelNumber));
-  phy.Set ("ChannelWidth", UintegerValue (m_channelWidth));
+  /**
+   * Set the propagation delay model used to compute the link delays.
+   * \param model the underlying propagation delay model
+   */
+  void SetUnderlyingModel (Ptr<PropagationDelayModel> model);
+  /**
+   * Compute the delays of all the links between the given nodes. All the nodes must
+   * have a ConstantPositionMobilityModel.
+   * \param nodes the given nodes
+   */
+  void Precompute (NodeContainer nodes);
+  virtual Time GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
 
-  WifiHelper wifi;
-  if (m_verbose)
-    {
-      wifi.EnableLogComponents ();
-    }
-  wifi.SetStandard (WIFI_PHY_STANDARD_80211ax_5GHZ);
-  std::ostringstream oss;
-  oss << "HeMcs" << m_mcs;
-  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
-                                "DataMode", StringValue (oss.str ()),
-                                "ControlMode", StringValue (oss.str ()));
-  switch (m_dlAckSeqType)
-    {
-    case 1:
-      wifi.SetAckPolicySelectorForAc (AC_BE, "ns3::ConstantWifiAckPolicySelector",
-                                      "DlAckSequenceType", UintegerValue (DlMuAckSequenceType::DL_SU_FORMAT));
-      break;
-    case 2:
-      wifi.SetAckPolicySelectorForAc (AC_BE, "ns3::ConstantWifiAckPolicySelector",
-                                      "DlAckSequenceType", UintegerValue (DlMuAckSequenceType::DL_MU_BAR));
-      break;
-    case 3:
-      wifi.SetAckPolicySelectorForAc (AC_BE, "ns3::ConstantWifiAckPolicySelector",
-                                      "DlAckSequenceType", UintegerValue (DlMuAckSequenceType::DL_AGGREGATE_TF));
-      break;
-    default:
-      NS_FATAL_ERROR ("Invalid DL ack sequence type (must be 1, 2 or 3)");
-    }
+private:
+  virtual int64_t DoAssignStreams (int64_t stream);
 
-  WifiMacHelper mac;
-  if (m_enableDlOfdma)
-    {
-      mac.SetOfdmaManager ("ns3::RrOfdmaManager",
-                           "NStations", UintegerValue (m_maxNRus),
-                           "ForceDlOfdma", BooleanValue (m_forceDlOfdma),
-                           "EnableUlOfdma", BooleanValue (m_enableUlOfdma),
-                           "UlPsduSize", UintegerValue (m_ulPsduSize));
-    }
+  Ptr<PropagationDelayModel> m_model; // underlying propagation delay model
+  std::unordered_map<const MobilityModel *, uint32_t> m_index;  // table index of the mobility model of each node
+  std::vector<Time> m_delays;         // delay of each link, indexed by (tx index, rx index)
+  uint32_t m_nNodes;                  // number of rows (and columns) of the table
+};
 
-  mac.SetType ("ns3::StaWifiMac",
-              "Ssid", SsidValue (Ssid ("non-existing-ssid")));  // prevent stations from automatically associating
-  m_staDevices = wifi.Install (phy, mac, m_staNodes);
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationDelayModel);
 
-  mac.SetType ("ns3::ApWifiMac",
-               "Ssid", SsidValue (m_ssid));
-  m_apDevices = wifi.Install (phy, mac, m_apNodes);
+TypeId
+CachedPropagationDelayModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedPropagationDelayModel")
+    .SetParent<PropagationDelayModel> ()
+    .AddConstructor<CachedPropagationDelayModel> ()
+  ;
+  return tid;
+}
 
-  // Configure max A-MSDU size and max A-MPDU size on the AP
-  Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice> (m_apDevices.Get (0));
-  dev->GetMac ()->SetAttribute ("BE_MaxAmsduSize", UintegerValue (m_maxAmsduSize));
-  dev->GetMac ()->SetAttribute ("BE_MaxAmpduSize", UintegerValue (m_maxAmpduSize));
-  m_channelCenterFrequency = dev->GetPhy ()->GetFrequency ();
-  // Configure TXOP Limit on the AP
-  PointerValue ptr;
-  dev->GetMac ()->GetAttribute ("BE_Txop", ptr);
-  ptr.Get<QosTxop> ()->SetTxopLimit (MicroSeconds (m_txopLimit));
+CachedPropagationDelayModel::CachedPropagationDelayModel ()
+  : m_nNodes (0)
+{
+}
 
-  // Configure max A-MSDU size and max A-MPDU size on the stations
-  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+void
+CachedPropagationDelayModel::SetUnderlyingModel (Ptr<PropagationDelayModel> model)
+{
+  m_model = model;
+}
+
+void
+CachedPropagationDelayModel::Precompute (NodeContainer nodes)
+{
+  NS_ASSERT (m_model != 0);
+  m_index.clear ();
+  std::vector<Ptr<MobilityModel> > mobility;
+  for (NodeContainer::Iterator it = nodes.Begin (); it != nodes.End (); it++)
     {
-      dev = DynamicCast<WifiNetDevice> (m_staDevices.Get (i));
-      dev->GetMac ()->SetAttribute ("BE_MaxAmsduSize", UintegerValue (m_maxAmsduSize));
-      dev->GetMac ()->SetAttribute ("BE_MaxAmpduSize", UintegerValue (m_maxAmpduSize));
-      m_dlStats[dev->GetMac ()->GetAddress ()] = DlStats ();
-      m_ulStats[dev->GetMac ()->GetAddress ()] = UlStats ();
+      Ptr<MobilityModel> model = (*it)->GetObject<ConstantPositionMobilityModel> ();
+      NS_ABORT_MSG_IF (model == 0, "Link delays can only be cached if all the nodes have a constant position");
+      m_index[PeekPointer (model)] = mobility.size ();
+      mobility.push_back (model);
     }
+  m_nNodes = mobility.size ();
+  m_delays.assign (m_nNodes * m_nNodes, Seconds (0));
 
-  // Setting mobility model
-  MobilityHelper mobility;
-  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
-
-  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
-  positionAlloc->Add (Vector (0.0, 0.0, 0.0));  // position of the AP
-  mobility.SetPositionAllocator (positionAlloc);
-  mobility.Install (m_apNodes);
-
-  mobility.SetPositionAllocator ("ns3::UniformDiscPositionAllocator",
-                                 "rho", DoubleValue (m_radius));
-  mobility.Install (m_staNodes);
-
-  /* Internet stack */
-  InternetStackHelper stack;
-  stack.Install (m_apNodes);
-  stack.Install (m_staNodes);
+  for (uint32_t tx = 0; tx < m_nNodes; tx++)
+    {
+      for (uint32_t rx = 0; rx < m_nNodes; rx++)
+        {
+          m_delays[tx * m_nNodes + rx] = m_model->GetDelay (mobility[tx], mobility[rx]);
+        }
+    }
+}
 
-  Ipv4AddressHelper address;
-  address.SetBase ("192.168.1.0", "255.255.255.0");
-  // Ipv4InterfaceContainer ApInterface;    //commented it jaishreeram
-  ApInterface = address.Assign (m_apDevices);
-  m_staInterfaces = address.Assign (m_staDevices);
+Time
+CachedPropagationDelayModel::GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  auto tx = m_index.find (PeekPointer (a));
+  auto rx = m_index.find (PeekPointer (b));
 
-  /* Traffic Control layer */
-  TrafficControlHelper tch;
-  if (m_queueDisc.compare ("default") != 0)
+  if (tx != m_index.end () && rx != m_index.end ())
     {
-      // Uninstall the root queue disc on the AP netdevice
-      tch.Uninstall (m_apDevices);
+      return m_delays[tx->second * m_nNodes + rx->second];
     }
+  return m_model->GetDelay (a, b);
+}
 
-  /* Transport and application layer */
-  std::string socketType = (m_transport.compare ("Tcp") == 0 ? "ns3::TcpSocketFactory" : "ns3::UdpSocketFactory");
-  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (2048)); //commented it jaishreeram
+int64_t
+CachedPropagationDelayModel::DoAssignStreams (int64_t stream)
+{
+  return (m_model != 0 ? m_model->AssignStreams (stream) : 0);
+}
 
-  PacketSinkHelper packetSinkHelper (socketType, InetSocketAddress (Ipv4Address::GetAny (), m_port));
-  // m_sinkApps = packetSinkHelper.Install (m_staNodes);
-  PacketSinkHelper bulkPacketSinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), m_port_bulk));
 
+/**
+ * \brief Cache of the durations of PPDUs and Trigger Frame solicited lengths
+ *
+ * The duration of a PPDU and of its PHY preamble and header only depend on the
+ * preamble type, the guard interval, the channel width, STBC and, for each PSDU,
+ * on its size, the MCS, the number of spatial streams and the RU size. The duration
+ * corresponding to the UL Length of a Trigger Frame only depends on the UL Length,
+ * the guard interval, the number of spatial streams and the channel width. Such
+ * parameters take few distinct values during a run, hence the durations are computed
+ * once and then looked up in hash tables keyed on the parameters packed in 64-bit
+ * words. If the cache is disabled, every duration is computed.
+ */
+class TxDurationCache
+{
+public:
+  TxDurationCache ();
 
-  //jaishreeram next few lines installs different applications for different nodes
-  for(uint32_t i=0;i<m_staNodes.GetN();i++){
-    if(i%2==0){  //if the station uses bulksend application - tcp
-      ApplicationContainer temp = bulkPacketSinkHelper.Install(m_staNodes.Get(i));
-      m_sinkApps_bulk.Add(temp); 
-    }
-    else{ //otherwise - udp version
-      ApplicationContainer temp = packetSinkHelper.Install(m_staNodes.Get(i));
-      m_sinkApps.Add(temp);
-    }
-  }
+  /// Durations of a PPDU
+  struct PpduDurations
+  {
+    Time duration;  ///< duration of the PPDU
+    Time overhead;  ///< duration of the PHY preamble and header
+  };
 
-  m_sinkApps.Stop (Seconds (m_warmup + m_simulationTime + 100)); // let the server be active for a long time
-  m_sinkApps_bulk.Stop (Seconds (m_warmup + m_simulationTime + 100)); // let the server be active for a long time jaishreeram
-  
+  /**
+   * Set the center frequency of the channel and clear the cache.
+   *
+   * \param frequency the center frequency of the channel (MHz)
+   */
+  void SetFrequency (uint16_t frequency);
+  /**
+   * \param enabled whether durations are looked up in the cache rather than computed
+   */
+  void SetEnabled (bool enabled);
+  /**
+   * \param psduMap the PSDUs carried by a PPDU
+   * \param txVector the TX vector of the PPDU
+   * \return the duration of the PPDU and of its PHY preamble and header
+   */
+  PpduDurations GetPpduDurations (const WifiPsduMap& psduMap, const WifiTxVector& txVector);
+  /**
+   * \param length the UL Length of a Trigger Frame
+   * \param heTbTxVector the TX vector of the solicited HE TB PPDUs
+   * \return the duration of the HE TB PPDUs solicited by the Trigger Frame
+   */
+  Time GetTfUlDuration (uint16_t length, const WifiTxVector& heTbTxVector);
+  /**
+   * \return the ratio of the lookups served by the cache
+   */
+  double GetHitRatio (void) const;
 
-  m_rxStart.assign (m_nStations, 0.0);
-  m_rxStop.assign (m_nStations, 0.0);
+private:
+  /// Parameters of a PPDU packed in one word, followed by one word per PSDU
+  typedef std::vector<uint64_t> Key;
 
-  for (uint16_t i = 0; i < m_nStations; i++)
-    {
-      m_appLatencyMap.insert (std::make_pair (i, std::vector<Time> ()));
-    }
+  /// Hash of a packed key
+  struct KeyHash
+  {
+    /**
+     * \param key a packed key
+     * \return the hash of the key
+     */
+    std::size_t operator() (const Key& key) const;
+  };
 
-  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::StaWifiMac/Assoc",
-                                 MakeCallback (&WifiDlOfdmaExample::EstablishBaAgreement, this));
+  uint16_t m_frequency;                 // center frequency of the channel (MHz)
+  bool m_enabled;                       // look up durations rather than computing them
+  Key m_key;                            // key of the last lookup (reused to avoid allocations)
+  std::unordered_map<Key, PpduDurations, KeyHash> m_ppduDurations;  // durations of PPDUs
+  std::unordered_map<uint64_t, Time> m_tfDurations;  // durations corresponding to Trigger Frame UL Lengths
+  uint64_t m_nLookups;                  // number of lookups
+  uint64_t m_nHits;                     // number of lookups served by the cache
+};
 
-  if (m_enablePcap)
+TxDurationCache::TxDurationCache ()
+  : m_frequency (0),
+    m_enabled (true),
+    m_nLookups (0),
+    m_nHits (0)
+{
+}
+
+std::size_t
+TxDurationCache::KeyHash::operator() (const Key& key) const
+{
+  // FNV-1a over the words of the key, with a final mix of the high bits
+  uint64_t hash = 14695981039346656037ULL;
+  for (uint64_t word : key)
     {
-      phy.EnablePcap ("STA_pcap_30STA_50SEC", m_staDevices);
-      phy.EnablePcap ("AP_pcap_30STA_50SEC", m_apDevices);
+      hash = (hash ^ word) * 1099511628211ULL;
     }
+  return static_cast<std::size_t> (hash ^ (hash >> 32));
 }
 
 void
-WifiDlOfdmaExample::Run (void)
+TxDurationCache::SetFrequency (uint16_t frequency)
 {
-  NS_LOG_FUNCTION (this);
-  std::cout<<"---Entering Run()---\n";
-  // Start the setup phase by having the first station associate with the AP
-  Simulator::ScheduleNow (&WifiDlOfdmaExample::StartAssociation, this);
+  m_frequency = frequency;
+  m_ppduDurations.clear ();
+  m_tfDurations.clear ();
+}
 
-  //Added for flow monitor
-  Ptr<FlowMonitor> flowMonitor;
+void
+TxDurationCache::SetEnabled (bool enabled)
+{
+  m_enabled = enabled;
+}
+
+TxDurationCache::PpduDurations
+TxDurationCache::GetPpduDurations (const WifiPsduMap& psduMap, const WifiTxVector& txVector)
+{
+  if (m_enabled)
+    {
+      bool isMu = (txVector.GetPreambleType () == WIFI_PREAMBLE_HE_MU
+                   || txVector.GetPreambleType () == WIFI_PREAMBLE_HE_TB);
+      m_key.clear ();
+      m_key.push_back (static_cast<uint64_t> (txVector.GetPreambleType ())
+                       | static_cast<uint64_t> (txVector.GetGuardInterval ()) << 8
+                       | static_cast<uint64_t> (txVector.GetChannelWidth ()) << 24
+                       | static_cast<uint64_t> (txVector.IsStbc ()) << 40
+                       | static_cast<uint64_t> (psduMap.size ()) << 48);
+      for (auto& psdu : psduMap)
+        {
+          m_key.push_back (static_cast<uint64_t> (psdu.second->GetSize ())
+                           | static_cast<uint64_t> (txVector.GetMode (psdu.first).GetUid () & 0xff) << 32
+                           | static_cast<uint64_t> (txVector.GetNss (psdu.first)) << 40
+                           | static_cast<uint64_t> (isMu ? txVector.GetRu (psdu.first).ruType : 0) << 48);
+        }
+      m_nLookups++;
+
+      auto it = m_ppduDurations.find (m_key);
+      if (it != m_ppduDurations.end ())
+        {
+          m_nHits++;
+          return it->second;
+        }
+    }
+  PpduDurations durations;
+  durations.duration = WifiPhy::CalculateTxDuration (psduMap, txVector, m_frequency);
+  durations.overhead = WifiPhy::CalculatePhyPreambleAndHeaderDuration (txVector);
+  if (m_enabled)
+    {
+      m_ppduDurations.insert ({m_key, durations});
+    }
+  return durations;
+}
+
+Time
+TxDurationCache::GetTfUlDuration (uint16_t length, const WifiTxVector& heTbTxVector)
+{
+  if (!m_enabled)
+    {
+      return WifiPhy::ConvertLSigLengthToHeTbPpduDuration (length, heTbTxVector, m_frequency);
+    }
+  uint64_t key = static_cast<uint64_t> (length)
+                 | static_cast<uint64_t> (heTbTxVector.GetNssMax ()) << 16
+                 | static_cast<uint64_t> (heTbTxVector.GetGuardInterval ()) << 24
+                 | static_cast<uint64_t> (heTbTxVector.GetChannelWidth ()) << 40;
+  m_nLookups++;
+
+  auto it = m_tfDurations.find (key);
+  if (it != m_tfDurations.end ())
+    {
+      m_nHits++;
+      return it->second;
+    }
+  Time duration = WifiPhy::ConvertLSigLengthToHeTbPpduDuration (length, heTbTxVector, m_frequency);
+  m_tfDurations.insert ({key, duration});
+  return duration;
+}
+
+double
+TxDurationCache::GetHitRatio (void) const
+{
+  return (m_nLookups > 0 ? static_cast<double> (m_nHits) / m_nLookups : 0.0);
+}
+
+
+/**
+ * \brief DL and UL statistics of the measurement period of a run
+ *
+ * The statistics are updated by the trace callbacks of WifiDlOfdmaExample during
+ * the simulation and by WifiDlOfdmaTraceReader when reading the binary trace of a
+ * run, hence both compute them in the same way. Stations are identified by their
+ * index; events related to unknown stations only update the aggregate statistics.
+ */
+class WifiDlOfdmaStats
+{
+public:
+  WifiDlOfdmaStats ();
+
+  /// Minimum, maximum and average of a series of samples
+  struct MinMaxAvg
+  {
+    double min {0.0};    ///< minimum sample (zero samples are replaced by the next sample)
+    double max {0.0};    ///< maximum sample
+    double avg {0.0};    ///< average of the samples
+    uint64_t count {0};  ///< number of samples
+    /**
+     * \param sample the sample to add
+     */
+    void Add (double sample);
+  };
+  /// Per-station DL statistics
+  struct DlStats
+  {
+    uint64_t failed {0};         ///< MPDUs not acknowledged
+    uint64_t expired {0};        ///< MSDUs expired in the queue
+    uint32_t minAmpduSize {0};   ///< minimum A-MPDU size (bytes)
+    uint32_t maxAmpduSize {0};   ///< maximum A-MPDU size (bytes)
+    uint64_t nAmpdus {0};        ///< number of A-MPDUs
+    MinMaxAvg ampduRatio;        ///< A-MPDU size to max A-MPDU size in DL MU PPDU ratio
+    Time lastTxTime;             ///< time the last MSDU was dequeued
+    MinMaxAvg holDelay;          ///< pairwise head-of-line delay (ms)
+  };
+  /// Per-station UL statistics
+  struct UlStats
+  {
+    MinMaxAvg lengthRatio;                   ///< HE TB PPDU duration to UL Length ratio (count of HE TB PPDUs)
+    uint64_t nSolicitingTriggerFrames {0};   ///< Basic Trigger Frames soliciting the station
+  };
+
+  /**
+   * Clear the statistics.
+   *
+   * \param nStations the number of stations
+   */
+  void Reset (std::size_t nStations);
+  /**
+   * \param sta the index of the receiver of an MPDU that was not acknowledged
+   */
+  void NotifyTxFailed (std::size_t sta);
+  /**
+   * \param sta the index of the receiver of an MSDU that expired in the queue
+   */
+  void NotifyMsduExpired (std::size_t sta);
+  /**
+   * \param sta the index of the receiver of an MSDU dequeued from the queue
+   * \param timestamp the time the MSDU was enqueued
+   * \param maxDelay the max delay of the queue
+   * \param now the time the MSDU was dequeued
+   */
+  void NotifyMsduDequeued (std::size_t sta, Time timestamp, Time maxDelay, Time now);
+  /**
+   * \param sta the index of the receiver of a PSDU carrying QoS data sent in the DL
+   * \param size the size of the PSDU
+   */
+  void NotifyDlPsdu (std::size_t sta, uint32_t size);
+  /**
+   * \param users the index of each station assigned an RU of a DL MU PPDU and the
+   *              size of the PSDU sent to it (zero if it was not sent a PSDU)
+   */
+  void NotifyDlMuPpdu (const std::vector<std::pair<std::size_t, uint32_t> >& users);
+  /**
+   * \param sta the index of the sender of an HE TB PPDU carrying QoS data
+   * \param duration the duration of the HE TB PPDU
+   */
+  void NotifyHeTbPpdu (std::size_t sta, Time duration);
+  /**
+   * \param ulLength the duration corresponding to the UL Length of a Basic Trigger Frame
+   * \param nUsers the number of User Info fields of the Basic Trigger Frame
+   */
+  void NotifyBasicTf (Time ulLength, std::size_t nUsers);
+  /**
+   * \param sta the index of a station solicited by the last Basic Trigger Frame
+   */
+  void NotifySolicitedSta (std::size_t sta);
+
+  /**
+   * \return the number of stations
+   */
+  std::size_t GetNStations (void) const;
+  /**
+   * \param sta the index of a station
+   * \return the DL statistics of the given station
+   */
+  const DlStats& GetDlStats (std::size_t sta) const;
+  /**
+   * \param sta the index of a station
+   * \return the UL statistics of the given station
+   */
+  const UlStats& GetUlStats (std::size_t sta) const;
+  /**
+   * \return the ratio of the sum of the A-MPDU sizes to the max A-MPDU size times the number of RUs of DL MU PPDUs
+   */
+  const MinMaxAvg& GetDlMuPpduCompleteness (void) const;
+  /**
+   * \return the head-of-line delay (ms)
+   */
+  const MinMaxAvg& GetHolDelay (void) const;
+  /**
+   * \return the ratio of the duration of the HE TB PPDUs to the time granted by the soliciting Basic Trigger Frame
+   */
+  const MinMaxAvg& GetHeTbPpduCompleteness (void) const;
+  /**
+   * \return the number of Basic Trigger Frames sent
+   */
+  uint64_t GetNBasicTriggerFramesSent (void) const;
+  /**
+   * \return the number of Basic Trigger Frames no station responded to
+   */
+  uint64_t GetNFailedTriggerFrames (void) const;
+  /**
+   * \return the duration corresponding to the UL Length of the last Basic Trigger Frame
+   */
+  Time GetTfUlLength (void) const;
+
+private:
+  std::vector<DlStats> m_dlStats;   // indexed by station index
+  std::vector<UlStats> m_ulStats;   // indexed by station index
+  MinMaxAvg m_ampduRatio;           // DL MU PPDU completeness
+  Time m_lastTxTime;                // time the last MSDU was dequeued
+  MinMaxAvg m_holDelay;             // head-of-line delay (ms)
+  uint64_t m_nBasicTriggerFramesSent;
+  uint64_t m_nFailedTriggerFrames;  // no station responded
+  MinMaxAvg m_lengthRatio;          // HE TB PPDU completeness
+  Time m_tfUlLength;                // TX duration coded in UL Length subfield of Trigger Frame
+  Time m_overallTimeGrantedByTf;    // m_tfUlLength times the number of addressed stations
+  Time m_responsesToLastTfDuration; // sum of the durations of the HE TB PPDUs in response to last TF
+};
+
+WifiDlOfdmaStats::WifiDlOfdmaStats ()
+{
+  Reset (0);
+}
+
+void
+WifiDlOfdmaStats::MinMaxAvg::Add (double sample)
+{
+  if (min == 0 || sample < min)
+    {
+      min = sample;
+    }
+  if (sample > max)
+    {
+      max = sample;
+    }
+  avg = (avg * count + sample) / (count + 1);
+  count++;
+}
+
+void
+WifiDlOfdmaStats::Reset (std::size_t nStations)
+{
+  m_dlStats.assign (nStations, DlStats ());
+  m_ulStats.assign (nStations, UlStats ());
+  m_ampduRatio = MinMaxAvg ();
+  m_lastTxTime = Seconds (0);
+  m_holDelay = MinMaxAvg ();
+  m_nBasicTriggerFramesSent = 0;
+  m_nFailedTriggerFrames = 0;
+  m_lengthRatio = MinMaxAvg ();
+  m_tfUlLength = Seconds (0);
+  m_overallTimeGrantedByTf = Seconds (0);
+  m_responsesToLastTfDuration = Seconds (0);
+}
+
+void
+WifiDlOfdmaStats::NotifyTxFailed (std::size_t sta)
+{
+  if (sta < m_dlStats.size ())
+    {
+      m_dlStats[sta].failed++;
+    }
+}
+
+void
+WifiDlOfdmaStats::NotifyMsduExpired (std::size_t sta)
+{
+  if (sta < m_dlStats.size ())
+    {
+      m_dlStats[sta].expired++;
+    }
+}
+
+void
+WifiDlOfdmaStats::NotifyMsduDequeued (std::size_t sta, Time timestamp, Time maxDelay, Time now)
+{
+  if (now > timestamp + maxDelay)
+    {
+      // the MSDU lifetime is higher than the max queue delay, hence the MSDU has been
+      // discarded. Do nothing in this case.
+      return;
+    }
+
+  // if this is an MSDU that has been dequeued to be aggregated to a previously
+  // dequeued MSDU, the HoL sample will be null. Do not count null HoL samples
+  if (m_lastTxTime.IsStrictlyPositive ())
+    {
+      double newHolSample = (now - m_lastTxTime).ToDouble (Time::MS);
+      if (newHolSample > 0.0)
+        {
+          m_holDelay.Add (newHolSample);
+        }
+    }
+  m_lastTxTime = now;
+
+  if (sta >= m_dlStats.size ())
+    {
+      return;
+    }
+  DlStats& stats = m_dlStats[sta];
+  if (stats.lastTxTime.IsStrictlyPositive ())
+    {
+      double newHolSample = (now - stats.lastTxTime).ToDouble (Time::MS);
+      if (newHolSample > 0.0)
+        {
+          stats.holDelay.Add (newHolSample);
+        }
+    }
+  stats.lastTxTime = now;
+}
+
+void
+WifiDlOfdmaStats::NotifyDlPsdu (std::size_t sta, uint32_t size)
+{
+  if (sta >= m_dlStats.size ())
+    {
+      return;
+    }
+  DlStats& stats = m_dlStats[sta];
+  if (stats.minAmpduSize == 0 || size < stats.minAmpduSize)
+    {
+      stats.minAmpduSize = size;
+    }
+  if (size > stats.maxAmpduSize)
+    {
+      stats.maxAmpduSize = size;
+    }
+  stats.nAmpdus++;
+}
+
+void
+WifiDlOfdmaStats::NotifyDlMuPpdu (const std::vector<std::pair<std::size_t, uint32_t> >& users)
+{
+  uint32_t maxAmpduSize = 0;
+  uint32_t ampduSizeSum = 0;
+  for (auto& user : users)
+    {
+      maxAmpduSize = std::max (maxAmpduSize, user.second);
+      ampduSizeSum += user.second;
+    }
+  if (maxAmpduSize == 0)
+    {
+      return;
+    }
+  m_ampduRatio.Add (static_cast<double> (ampduSizeSum) / (maxAmpduSize * users.size ()));
+
+  for (auto& user : users)
+    {
+      // the ratio is null for a station that was assigned an RU but not sent a PSDU
+      if (user.first < m_dlStats.size ())
+        {
+          m_dlStats[user.first].ampduRatio.Add (static_cast<double> (user.second) / maxAmpduSize);
+        }
+    }
+}
+
+void
+WifiDlOfdmaStats::NotifyHeTbPpdu (std::size_t sta, Time duration)
+{
+  m_responsesToLastTfDuration += duration;
+  if (sta < m_ulStats.size ())
+    {
+      m_ulStats[sta].lengthRatio.Add (duration.GetSeconds () / m_tfUlLength.GetSeconds ());
+    }
+}
+
+void
+WifiDlOfdmaStats::NotifyBasicTf (Time ulLength, std::size_t nUsers)
+{
+  if (m_tfUlLength.IsStrictlyPositive ())
+    {
+      // This is not the first Trigger Frame being sent
+      if (m_responsesToLastTfDuration.IsZero ())
+        {
+          // no station responded to the previous TF
+          m_nFailedTriggerFrames++;
+        }
+      else
+        {
+          m_lengthRatio.Add (m_responsesToLastTfDuration.GetSeconds () / m_overallTimeGrantedByTf.GetSeconds ());
+        }
+    }
+
+  m_nBasicTriggerFramesSent++;
+  m_responsesToLastTfDuration = Seconds (0);
+  m_tfUlLength = ulLength;
+  m_overallTimeGrantedByTf = ulLength * nUsers;
+}
+
+void
+WifiDlOfdmaStats::NotifySolicitedSta (std::size_t sta)
+{
+  if (sta < m_ulStats.size ())
+    {
+      m_ulStats[sta].nSolicitingTriggerFrames++;
+    }
+}
+
+std::size_t
+WifiDlOfdmaStats::GetNStations (void) const
+{
+  return m_dlStats.size ();
+}
+
+const WifiDlOfdmaStats::DlStats&
+WifiDlOfdmaStats::GetDlStats (std::size_t sta) const
+{
+  return m_dlStats.at (sta);
+}
+
+const WifiDlOfdmaStats::UlStats&
+WifiDlOfdmaStats::GetUlStats (std::size_t sta) const
+{
+  return m_ulStats.at (sta);
+}
+
+const WifiDlOfdmaStats::MinMaxAvg&
+WifiDlOfdmaStats::GetDlMuPpduCompleteness (void) const
+{
+  return m_ampduRatio;
+}
+
+const WifiDlOfdmaStats::MinMaxAvg&
+WifiDlOfdmaStats::GetHolDelay (void) const
+{
+  return m_holDelay;
+}
+
+const WifiDlOfdmaStats::MinMaxAvg&
+WifiDlOfdmaStats::GetHeTbPpduCompleteness (void) const
+{
+  return m_lengthRatio;
+}
+
+uint64_t
+WifiDlOfdmaStats::GetNBasicTriggerFramesSent (void) const
+{
+  return m_nBasicTriggerFramesSent;
+}
+
+uint64_t
+WifiDlOfdmaStats::GetNFailedTriggerFrames (void) const
+{
+  return m_nFailedTriggerFrames;
+}
+
+Time
+WifiDlOfdmaStats::GetTfUlLength (void) const
+{
+  return m_tfUlLength;
+}
+
+
+/**
+ * \brief Fixed-size record of the binary trace of a run
+ *
+ * A PPDU is traced as a sequence of records sharing the same PPDU number: one
+ * record per PSDU (for DL MU PPDUs, one record per RU, with a null size if the
+ * station assigned the RU was not sent a PSDU). A Basic Trigger Frame is followed
+ * by one record per solicited station.
+ */
+struct TraceRecord
+{
+  /// Record types
+  enum Type : uint8_t
+  {
+    PSDU = 0,      ///< PSDU (or RU) of a PPDU
+    TF_USER,       ///< station solicited by the last Basic Trigger Frame
+    DEQUEUE,       ///< MSDU dequeued from the BE EDCA queue of the AP
+    EXPIRED,       ///< MSDU expired in the BE EDCA queue of the AP
+    TX_FAILED      ///< MPDU not acknowledged
+  };
+  /// Kinds of the frame carried by a PSDU
+  enum Kind : uint8_t
+  {
+    QOS_DATA = 0,  ///< QoS data frame
+    BASIC_TF,      ///< Basic Trigger Frame
+    MU_BAR,        ///< MU-BAR Trigger Frame
+    OTHER_TF,      ///< other Trigger Frame
+    BLOCK_ACK,     ///< BlockAck, BlockAckReq or Ack frame
+    OTHER          ///< other frame
+  };
+  static const uint16_t NO_STA = 0xffff;  ///< station index of frames not related to a station
+
+  int64_t time;      ///< simulation time (ns)
+  int64_t value;     ///< PPDU duration (PSDU), UL Length duration (Basic TF) or MSDU timestamp (DEQUEUE) in ns
+  uint32_t ppdu;     ///< number of the PPDU (PSDU, TF_USER)
+  uint32_t size;     ///< PSDU size (bytes) or number of User Info fields (Basic TF)
+  uint16_t sta;      ///< station index
+  uint8_t type;      ///< record type
+  uint8_t kind;      ///< kind of frame (PSDU)
+  uint8_t preamble;  ///< preamble type of the PPDU (PSDU)
+  uint8_t uplink;    ///< whether the PPDU was sent by a station (PSDU)
+  uint16_t reserved; ///< padding
+};
+
+static_assert (sizeof (TraceRecord) == 32, "Trace records must be 32 bytes long");
+
+/**
+ * \brief Header of the binary trace of a run
+ */
+struct TraceHeader
+{
+  char magic[4];       ///< "WDOT"
+  uint32_t version;    ///< version of the trace format
+  uint32_t nStations;  ///< number of stations
+  uint32_t reserved;   ///< padding
+  int64_t maxDelay;    ///< max delay of the BE EDCA queue of the AP (ns)
+  int64_t start;       ///< start of the measurement period (ns)
+};
+
+static const uint32_t TRACE_VERSION = 1;  ///< version of the trace format
+
+/**
+ * \brief Append-only buffered writer of a binary trace
+ *
+ * Records are collected in a buffer, which is written to the file when full
+ * and when the trace is closed.
+ */
+class BinaryTraceWriter
+{
+public:
+  /**
+   * Create a closed writer.
+   *
+   * \param bufferSize the number of records buffered before writing to the file
+   */
+  BinaryTraceWriter (std::size_t bufferSize = 8192);
+  ~BinaryTraceWriter ();
+
+  /**
+   * Create the given file and write the header of the trace.
+   *
+   * \param fileName the name of the file
+   * \param header the header of the trace
+   */
+  void Open (const std::string& fileName, const TraceHeader& header);
+  /**
+   * \return whether the trace is open
+   */
+  bool IsOpen (void) const;
+  /**
+   * Append a record to the trace.
+   *
+   * \param record the record
+   */
+  void Write (const TraceRecord& record);
+  /**
+   * Write the buffered records and close the file.
+   */
+  void Close (void);
+
+private:
+  /**
+   * Write the buffered records to the file.
+   */
+  void Flush (void);
+
+  std::FILE *m_file;                    // trace file
+  std::vector<TraceRecord> m_buffer;    // records not written yet
+  std::size_t m_bufferSize;             // max number of buffered records
+};
+
+BinaryTraceWriter::BinaryTraceWriter (std::size_t bufferSize)
+  : m_file (nullptr),
+    m_bufferSize (bufferSize)
+{
+}
+
+BinaryTraceWriter::~BinaryTraceWriter ()
+{
+  Close ();
+}
+
+void
+BinaryTraceWriter::Open (const std::string& fileName, const TraceHeader& header)
+{
+  Close ();
+  m_file = std::fopen (fileName.c_str (), "wb");
+  NS_ABORT_MSG_IF (m_file == nullptr, "Cannot create trace file " << fileName << ": " << std::strerror (errno));
+  NS_ABORT_MSG_IF (std::fwrite (&header, sizeof (header), 1, m_file) != 1, "Cannot write trace file " << fileName);
+  m_buffer.reserve (m_bufferSize);
+}
+
+bool
+BinaryTraceWriter::IsOpen (void) const
+{
+  return m_file != nullptr;
+}
+
+void
+BinaryTraceWriter::Write (const TraceRecord& record)
+{
+  m_buffer.push_back (record);
+  if (m_buffer.size () >= m_bufferSize)
+    {
+      Flush ();
+    }
+}
+
+void
+BinaryTraceWriter::Flush (void)
+{
+  if (!m_buffer.empty ())
+    {
+      NS_ABORT_MSG_IF (std::fwrite (m_buffer.data (), sizeof (TraceRecord), m_buffer.size (), m_file) != m_buffer.size (),
+                       "Cannot write trace file: " << std::strerror (errno));
+      m_buffer.clear ();
+    }
+}
+
+void
+BinaryTraceWriter::Close (void)
+{
+  if (m_file != nullptr)
+    {
+      Flush ();
+      std::fclose (m_file);
+      m_file = nullptr;
+    }
+}
+
+
+/**
+ * \param address a MAC address
+ * \return the integer whose 48 least significant bits are the given MAC address
+ */
+static uint64_t
+AddressToInteger (Mac48Address address)
+{
+  uint8_t buffer[6];
+  address.CopyTo (buffer);
+  uint64_t value = 0;
+  for (uint8_t i = 0; i < 6; i++)
+    {
+      value = (value << 8) | buffer[i];
+    }
+  return value;
+}
+
+
+/**
+ * \param bw the channel width (MHz)
+ * \param nStations the number of stations to serve
+ * \return the largest RU type such that the given number of equal-sized RUs fit the channel
+ */
+static HeRu::RuType
+GetEqualSizedRuType (uint16_t bw, std::size_t nStations)
+{
+  HeRu::RuType ruType = HeRu::RU_26_TONE;
+  for (HeRu::RuType type : {HeRu::RU_52_TONE, HeRu::RU_106_TONE, HeRu::RU_242_TONE,
+                            HeRu::RU_484_TONE, HeRu::RU_996_TONE, HeRu::RU_2x996_TONE})
+    {
+      if (HeRu::GetNRus (bw, type) < nStations)
+        {
+          break;
+        }
+      ruType = type;
+    }
+  return ruType;
+}
+
+/**
+ * \param ruType an RU type
+ * \return the number of data and pilot subcarriers of an RU of the given type
+ */
+static uint16_t
+GetNTones (HeRu::RuType ruType)
+{
+  switch (ruType)
+    {
+    case HeRu::RU_26_TONE:
+      return 26;
+    case HeRu::RU_52_TONE:
+      return 52;
+    case HeRu::RU_106_TONE:
+      return 106;
+    case HeRu::RU_242_TONE:
+      return 242;
+    case HeRu::RU_484_TONE:
+      return 484;
+    case HeRu::RU_996_TONE:
+      return 996;
+    default:
+      return 1992;
+    }
+}
+
+/**
+ * \brief OFDMA manager ranking stations by head-of-line delay and deadline
+ *
+ * Unlike RrOfdmaManager, which serves stations in a round-robin order, this
+ * manager ranks the stations having an established Block Ack agreement and
+ * MSDUs queued in the EDCA queue granted the channel as follows:
+ *
+ * - the stations declared latency-sensitive through SetLatencySensitive (such as
+ *   the stations receiving voice-like flows) are constrained by the DelayBudget and
+ *   are served first, in increasing order of slack (i.e., of the time left until
+ *   the MSDU at the head of their queue exceeds the budget);
+ * - the other stations are served next, in decreasing order of the age of the
+ *   MSDU at the head of their queue.
+ *
+ * The number of stations served by a DL MU PPDU is the one maximizing the amount
+ * of queued bytes that can be transmitted in the available time by equal-sized RUs,
+ * given the backlog of the stations, among the values allowing all the
+ * delay-constrained stations to be served (up to NStations). The RUs are then sized
+ * to the backlog of the stations: starting from the whole channel, an RU is split
+ * into the two RUs of the next smaller size (the central 26-tone RUs are not used)
+ * and the stations are distributed between them, the station with the largest
+ * backlog going to the RU with the most tones left, until each RU serves a single
+ * station. If more stations are served than the RUs that can be obtained in this
+ * way, the stations are assigned equal-sized RUs.
+ *
+ * UL OFDMA is not supported.
+ */
+class DelayAwareOfdmaManager : public OfdmaManager
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  DelayAwareOfdmaManager ();
+  virtual ~DelayAwareOfdmaManager ();
+
+  /**
+   * Declare that the traffic addressed to the given station is latency-sensitive,
+   * i.e., constrained by the DelayBudget.
+   *
+   * \param address the MAC address of the station
+   */
+  void SetLatencySensitive (Mac48Address address);
+
+protected:
+  virtual void DoInitialize (void);
+  virtual void DoDispose (void);
+
+private:
+  virtual OfdmaTxFormat SelectTxFormat (Ptr<const WifiMacQueueItem> mpdu);
+  virtual DlOfdmaInfo ComputeDlOfdmaInfo (void);
+  virtual UlOfdmaInfo ComputeUlOfdmaInfo (void);
+
+  /// Station that can be served by the next DL MU PPDU
+  struct Candidate
+  {
+    uint16_t aid;                       ///< association ID
+    Mac48Address address;               ///< MAC address
+    Ptr<const WifiMacQueueItem> mpdu;   ///< next MPDU to transmit to the station
+    uint32_t backlog;                   ///< bytes queued for the station
+    bool constrained;                   ///< whether the station is constrained by the delay budget
+    Time rank;                          ///< slack (constrained stations) or HoL age (other stations)
+    HeRu::RuSpec ru;                    ///< RU assigned to the station
+  };
+  /**
+   * \param a a candidate station
+   * \param b another candidate station
+   * \return true if station a has to be served before station b
+   */
+  static bool IsMoreUrgent (const Candidate& a, const Candidate& b);
+  /**
+   * Add the given MSDU to the backlog of its receiver.
+   *
+   * \param item the MSDU enqueued into the BE EDCA queue
+   */
+  void NotifyEnqueue (Ptr<const WifiMacQueueItem> item);
+  /**
+   * Remove the given MSDU from the backlog of its receiver.
+   *
+   * \param item the MSDU dequeued (or removed) from the BE EDCA queue
+   */
+  void NotifyDequeue (Ptr<const WifiMacQueueItem> item);
+  /**
+   * \param ru an RU
+   * \return the two RUs of the next smaller size covering the given RU, except the
+   *         central 26-tone RU (no RU is returned for a 26-tone RU)
+   */
+  static std::vector<HeRu::RuSpec> SplitRu (const HeRu::RuSpec& ru);
+  /**
+   * \param ru an RU
+   * \param children the RUs returned by SplitRu for the given RU
+   * \return true if the given RUs are two disjoint RUs lying inside the given RU
+   */
+  static bool IsSplitValid (const HeRu::RuSpec& ru, const std::vector<HeRu::RuSpec>& children);
+  /**
+   * \param ruType an RU type
+   * \return the maximum number of stations that can be served by splitting an RU of the given type
+   */
+  static std::size_t GetMaxStations (HeRu::RuType ruType);
+  /**
+   * Assign the candidates RUs sized to their backlog by recursively splitting the given RU.
+   *
+   * \param ru the RU to split
+   * \param stas the indices of the candidates to serve in the given RU, by decreasing demand
+   * \param demand the number of tones required by each candidate to transmit its backlog
+   */
+  void AssignRus (const HeRu::RuSpec& ru, const std::vector<std::size_t>& stas, const std::vector<double>& demand);
+
+  uint8_t m_nStations;                 // max number of stations served by a DL MU PPDU
+  bool m_forceDlOfdma;                 // use DL OFDMA even if a single station can be served
+  Time m_delayBudget;                  // delay budget of latency-sensitive stations
+  std::set<Mac48Address> m_latencySensitive;  // stations whose traffic is latency-sensitive
+  Ptr<WifiMacQueue> m_queue;           // BE EDCA queue
+  std::unordered_map<uint64_t /* MAC address */, uint32_t> m_backlog;  // bytes queued for each receiver
+  std::vector<Candidate> m_candidates; // stations to serve with the next DL MU PPDU
+};
+
+NS_OBJECT_ENSURE_REGISTERED (DelayAwareOfdmaManager);
+
+TypeId
+DelayAwareOfdmaManager::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::DelayAwareOfdmaManager")
+    .SetParent<OfdmaManager> ()
+    .AddConstructor<DelayAwareOfdmaManager> ()
+    .AddAttribute ("NStations",
+                   "The maximum number of stations that can be granted an RU in a DL MU PPDU",
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&DelayAwareOfdmaManager::m_nStations),
+                   MakeUintegerChecker<uint8_t> (1, 74))
+    .AddAttribute ("ForceDlOfdma",
+                   "If enabled, return DL_OFDMA even if just one station can be served.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DelayAwareOfdmaManager::m_forceDlOfdma),
+                   MakeBooleanChecker ())
+    .AddAttribute ("DelayBudget",
+                   "The delay budget of the MSDUs addressed to latency-sensitive stations",
+                   TimeValue (MilliSeconds (20)),
+                   MakeTimeAccessor (&DelayAwareOfdmaManager::m_delayBudget),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+DelayAwareOfdmaManager::DelayAwareOfdmaManager ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+DelayAwareOfdmaManager::~DelayAwareOfdmaManager ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+}
+
+void
+DelayAwareOfdmaManager::SetLatencySensitive (Mac48Address address)
+{
+  NS_LOG_FUNCTION (this << address);
+  m_latencySensitive.insert (address);
+}
+
+void
+DelayAwareOfdmaManager::DoInitialize (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_apMac != 0);
+  // DL OFDMA is only used for best effort traffic in this scenario
+  PointerValue ptr;
+  m_apMac->GetAttribute ("BE_Txop", ptr);
+  m_queue = ptr.Get<QosTxop> ()->GetWifiMacQueue ();
+  m_queue->TraceConnectWithoutContext ("Enqueue", MakeCallback (&DelayAwareOfdmaManager::NotifyEnqueue, this));
+  m_queue->TraceConnectWithoutContext ("Dequeue", MakeCallback (&DelayAwareOfdmaManager::NotifyDequeue, this));
+  OfdmaManager::DoInitialize ();
+}
+
+void
+DelayAwareOfdmaManager::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_queue != 0)
+    {
+      m_queue->TraceDisconnectWithoutContext ("Enqueue", MakeCallback (&DelayAwareOfdmaManager::NotifyEnqueue, this));
+      m_queue->TraceDisconnectWithoutContext ("Dequeue", MakeCallback (&DelayAwareOfdmaManager::NotifyDequeue, this));
+      m_queue = 0;
+    }
+  m_backlog.clear ();
+  m_candidates.clear ();
+  OfdmaManager::DoDispose ();
+}
+
+bool
+DelayAwareOfdmaManager::IsMoreUrgent (const Candidate& a, const Candidate& b)
+{
+  if (a.constrained != b.constrained)
+    {
+      return a.constrained;
+    }
+  // least slack first for constrained stations, oldest HoL MSDU first for the others
+  return (a.constrained ? a.rank < b.rank : a.rank > b.rank);
+}
+
+void
+DelayAwareOfdmaManager::NotifyEnqueue (Ptr<const WifiMacQueueItem> item)
+{
+  m_backlog[AddressToInteger (item->GetHeader ().GetAddr1 ())] += item->GetSize ();
+}
+
+void
+DelayAwareOfdmaManager::NotifyDequeue (Ptr<const WifiMacQueueItem> item)
+{
+  auto it = m_backlog.find (AddressToInteger (item->GetHeader ().GetAddr1 ()));
+  if (it != m_backlog.end ())
+    {
+      // MSDUs enqueued before the manager was initialized were not counted
+      it->second -= std::min (it->second, item->GetSize ());
+    }
+}
+
+OfdmaTxFormat
+DelayAwareOfdmaManager::SelectTxFormat (Ptr<const WifiMacQueueItem> mpdu)
+{
+  NS_LOG_FUNCTION (this << mpdu);
+
+  m_candidates.clear ();
+  if (mpdu != 0 && !mpdu->GetHeader ().IsQosData ())
+    {
+      return OfdmaTxFormat::NON_OFDMA;
+    }
+
+  // TIDs mapped to the BE AC
+  static const uint8_t beTids[] = {0, 3};
+  Time now = Simulator::Now ();
+  for (auto& sta : m_apMac->GetStaList ())
+    {
+      Candidate candidate;
+      candidate.aid = sta.first;
+      candidate.address = sta.second;
+      candidate.mpdu = 0;
+      for (uint8_t tid : beTids)
+        {
+          if (!m_low->GetBaAgreementEstablished (sta.second, tid))
+            {
+              continue;
+            }
+          // MPDUs to retransmit are returned first
+          Ptr<const WifiMacQueueItem> item = m_edca->PeekNextFrame (tid, sta.second);
+          if (item != 0 && (candidate.mpdu == 0 || item->GetTimeStamp () < candidate.mpdu->GetTimeStamp ()))
+            {
+              candidate.mpdu = item;
+            }
+        }
+      if (candidate.mpdu == 0)
+        {
+          continue;
+        }
+      auto backlogIt = m_backlog.find (AddressToInteger (sta.second));
+      candidate.backlog = (backlogIt != m_backlog.end () ? backlogIt->second : 0);
+      candidate.constrained = (m_latencySensitive.find (sta.second) != m_latencySensitive.end ());
+      Time age = now - candidate.mpdu->GetTimeStamp ();
+      candidate.rank = (candidate.constrained ? m_delayBudget - age : age);
+      m_candidates.push_back (candidate);
+    }
+
+  std::sort (m_candidates.begin (), m_candidates.end (), &DelayAwareOfdmaManager::IsMoreUrgent);
+
+  std::size_t maxStations = std::min (static_cast<std::size_t> (m_nStations), m_candidates.size ());
+  if (maxStations == 0 || (maxStations == 1 && !m_forceDlOfdma))
+    {
+      m_candidates.clear ();
+      return OfdmaTxFormat::NON_OFDMA;
+    }
+
+  // Select the number of stations maximizing the bytes that can be transmitted in
+  // the available time, without leaving out delay-constrained stations
+  uint16_t bw = m_low->GetPhy ()->GetChannelWidth ();
+  WifiTxVector suTxVector = m_low->GetDataTxVector (m_candidates.front ().mpdu);
+  double bytesPerTone = suTxVector.GetMode ().GetDataRate (bw, suTxVector.GetGuardInterval (),
+                                                           suTxVector.GetNss ()) / 8.
+                        / GetNTones (GetEqualSizedRuType (bw, 1))
+                        * (m_availableTime.IsStrictlyPositive () && m_availableTime != Time::Min ()
+                           ? m_availableTime : GetPpduMaxTime (WIFI_PREAMBLE_HE_MU)).GetSeconds ();
+  std::size_t nConstrained = 0;
+  while (nConstrained < maxStations && m_candidates[nConstrained].constrained)
+    {
+      nConstrained++;
+    }
+
+  std::size_t nStations = maxStations;
+  double maxBytes = 0;
+  for (std::size_t n = std::max<std::size_t> (nConstrained, 1); n <= maxStations; n++)
+    {
+      double ruBytes = bytesPerTone * GetNTones (GetEqualSizedRuType (bw, n));
+      double bytes = 0;
+      for (std::size_t i = 0; i < n; i++)
+        {
+          bytes += std::min<double> (m_candidates[i].backlog, ruBytes);
+        }
+      if (bytes > maxBytes)
+        {
+          maxBytes = bytes;
+          nStations = n;
+        }
+    }
+  m_candidates.resize (nStations);
+
+  if (nStations == 1 && !m_forceDlOfdma)
+    {
+      m_candidates.clear ();
+      return OfdmaTxFormat::NON_OFDMA;
+    }
+
+  HeRu::RuSpec channelRu;
+  channelRu.primary80MHz = true;
+  channelRu.ruType = GetEqualSizedRuType (bw, 1);
+  channelRu.index = 1;
+  if (nStations <= GetMaxStations (channelRu.ruType))
+    {
+      // RUs sized to the backlog of the stations
+      std::vector<double> demand;
+      std::vector<std::size_t> stas;
+      for (std::size_t i = 0; i < nStations; i++)
+        {
+          demand.push_back (m_candidates[i].backlog / bytesPerTone);
+          stas.push_back (i);
+        }
+      std::stable_sort (stas.begin (), stas.end (),
+                        [&demand] (std::size_t a, std::size_t b) { return demand[a] > demand[b]; });
+      AssignRus (channelRu, stas, demand);
+    }
+  else
+    {
+      // Equal-sized RUs, assigned in the order of urgency. In a 160 MHz channel,
+      // the RU index is relative to the 80 MHz segment
+      HeRu::RuType ruType = GetEqualSizedRuType (bw, nStations);
+      std::size_t nRusPerSegment = (bw == 160 && ruType != HeRu::RU_2x996_TONE
+                                    ? HeRu::GetNRus (80, ruType) : HeRu::GetNRus (bw, ruType));
+      for (std::size_t i = 0; i < nStations; i++)
+        {
+          m_candidates[i].ru.primary80MHz = (i < nRusPerSegment);
+          m_candidates[i].ru.ruType = ruType;
+          m_candidates[i].ru.index = i % nRusPerSegment + 1;
+        }
+    }
+  return OfdmaTxFormat::DL_OFDMA;
+}
+
+std::vector<HeRu::RuSpec>
+DelayAwareOfdmaManager::SplitRu (const HeRu::RuSpec& ru)
+{
+  std::vector<HeRu::RuSpec> children;
+  HeRu::RuSpec child;
+  child.primary80MHz = ru.primary80MHz;
+
+  switch (ru.ruType)
+    {
+    case HeRu::RU_52_TONE:
+      {
+        // the 52-tone RUs of each 20 MHz subchannel cover the 26-tone RUs 1-2, 3-4, 6-7 and 8-9
+        // of the subchannel. In an 80 MHz segment, the 26-tone RU 19 lies between the
+        // second and the third subchannel
+        std::size_t subchannel = (ru.index - 1) / 4;
+        std::size_t position = (ru.index - 1) % 4;
+        child.ruType = HeRu::RU_26_TONE;
+        child.index = 9 * subchannel + 2 * position + (position < 2 ? 1 : 2) + (subchannel < 2 ? 0 : 1);
+        children.push_back (child);
+        child.index++;
+        children.push_back (child);
+        return children;
+      }
+    case HeRu::RU_106_TONE:
+      child.ruType = HeRu::RU_52_TONE;
+      break;
+    case HeRu::RU_242_TONE:
+      child.ruType = HeRu::RU_106_TONE;
+      break;
+    case HeRu::RU_484_TONE:
+      child.ruType = HeRu::RU_242_TONE;
+      break;
+    case HeRu::RU_996_TONE:
+      child.ruType = HeRu::RU_484_TONE;
+      break;
+    case HeRu::RU_2x996_TONE:
+      // one 996-tone RU in each 80 MHz segment
+      child.ruType = HeRu::RU_996_TONE;
+      child.index = 1;
+      child.primary80MHz = true;
+      children.push_back (child);
+      child.primary80MHz = false;
+      children.push_back (child);
+      return children;
+    default:
+      return children;
+    }
+  // RUs of the other sizes cover the two RUs of the next smaller size with the same position
+  child.index = 2 * ru.index - 1;
+  children.push_back (child);
+  child.index++;
+  children.push_back (child);
+  return children;
+}
+
+bool
+DelayAwareOfdmaManager::IsSplitValid (const HeRu::RuSpec& ru, const std::vector<HeRu::RuSpec>& children)
+{
+  if (children.size () != 2)
+    {
+      return false;
+    }
+  if (ru.ruType == HeRu::RU_2x996_TONE)
+    {
+      return (children[0].ruType == HeRu::RU_996_TONE && children[1].ruType == HeRu::RU_996_TONE
+              && children[0].primary80MHz != children[1].primary80MHz);
+    }
+
+  // RU indices are relative to the 80 MHz segment and the RUs of a 20 MHz or 40 MHz
+  // channel are nested like the RUs with the same indices in an 80 MHz channel,
+  // hence the subcarriers are taken from the tone plan of an 80 MHz channel
+  HeRu::SubcarrierGroup parent = HeRu::GetSubcarrierGroup (80, ru.ruType, ru.index);
+  HeRu::SubcarrierGroup tones[2];
+  for (std::size_t i = 0; i < 2; i++)
+    {
+      if (children[i].primary80MHz != ru.primary80MHz)
+        {
+          return false;
+        }
+      tones[i] = HeRu::GetSubcarrierGroup (80, children[i].ruType, children[i].index);
+      for (const auto& range : tones[i])
+        {
+          if (std::none_of (parent.begin (), parent.end (),
+                            [&range] (const HeRu::SubcarrierRange& p)
+                            { return p.first <= range.first && range.second <= p.second; }))
+            {
+              return false;
+            }
+        }
+    }
+  for (const auto& a : tones[0])
+    {
+      for (const auto& b : tones[1])
+        {
+          if (a.first <= b.second && b.first <= a.second)
+            {
+              return false;
+            }
+        }
+    }
+  return true;
+}
+
+std::size_t
+DelayAwareOfdmaManager::GetMaxStations (HeRu::RuType ruType)
+{
+  switch (ruType)
+    {
+    case HeRu::RU_26_TONE:
+      return 1;
+    case HeRu::RU_52_TONE:
+      return 2;
+    case HeRu::RU_106_TONE:
+      return 4;
+    case HeRu::RU_242_TONE:
+      return 8;
+    case HeRu::RU_484_TONE:
+      return 16;
+    case HeRu::RU_996_TONE:
+      return 32;
+    default:
+      return 64;
+    }
+}
+
+void
+DelayAwareOfdmaManager::AssignRus (const HeRu::RuSpec& ru, const std::vector<std::size_t>& stas,
+                                   const std::vector<double>& demand)
+{
+  NS_ASSERT (!stas.empty () && stas.size () <= GetMaxStations (ru.ruType));
+  if (stas.size () == 1)
+    {
+      m_candidates[stas.front ()].ru = ru;
+      return;
+    }
+
+  std::vector<HeRu::RuSpec> children = SplitRu (ru);
+  NS_ASSERT (IsSplitValid (ru, children));
+  std::size_t maxStations = GetMaxStations (children.front ().ruType);
+  std::vector<std::size_t> assigned[2];
+  double tonesLeft[2] = {static_cast<double> (GetNTones (children[0].ruType)),
+                         static_cast<double> (GetNTones (children[1].ruType))};
+  for (std::size_t i = 0; i < stas.size (); i++)
+    {
+      // each half serves at least one station, the others go to the half with the
+      // most tones left (stations are sorted by decreasing demand)
+      std::size_t half = (i < 2 ? i : (tonesLeft[0] >= tonesLeft[1] ? 0 : 1));
+      if (assigned[half].size () == maxStations)
+        {
+          half = 1 - half;
+        }
+      assigned[half].push_back (stas[i]);
+      tonesLeft[half] -= demand[stas[i]];
+    }
+  AssignRus (children[0], assigned[0], demand);
+  AssignRus (children[1], assigned[1], demand);
+}
+
+OfdmaManager::DlOfdmaInfo
+DelayAwareOfdmaManager::ComputeDlOfdmaInfo (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  DlOfdmaInfo dlOfdmaInfo;
+  if (m_candidates.empty ())
+    {
+      return dlOfdmaInfo;
+    }
+
+  uint16_t bw = m_low->GetPhy ()->GetChannelWidth ();
+  WifiTxVector suTxVector = m_low->GetDataTxVector (m_candidates.front ().mpdu);
+  WifiTxVector txVector;
+  txVector.SetPreambleType (WIFI_PREAMBLE_HE_MU);
+  txVector.SetChannelWidth (bw);
+  txVector.SetGuardInterval (suTxVector.GetGuardInterval ());
+  txVector.SetTxPowerLevel (suTxVector.GetTxPowerLevel ());
+  dlOfdmaInfo.txVector = txVector;
+
+  std::vector<HeMuUserInfo> userInfo;
+  for (std::size_t i = 0; i < m_candidates.size (); i++)
+    {
+      WifiTxVector staTxVector = m_low->GetDataTxVector (m_candidates[i].mpdu);
+      userInfo.push_back ({m_candidates[i].ru, staTxVector.GetMode (), staTxVector.GetNss ()});
+      txVector.SetHeMuUserInfo (m_candidates[i].aid, userInfo.back ());
+    }
+
+  // only the stations that are granted a PSDU are included in the TX vector of the DL MU PPDU
+  Time ppduDurationLimit = (m_availableTime.IsStrictlyPositive () ? m_availableTime : Time::Min ());
+  for (std::size_t i = 0; i < m_candidates.size (); i++)
+    {
+      Ptr<WifiMacQueueItem> mpdu = m_edca->DequeuePeekedFrame (m_candidates[i].mpdu, txVector,
+                                                               true, 0, ppduDurationLimit);
+      if (mpdu == 0)
+        {
+          continue;
+        }
+      std::vector<Ptr<WifiMacQueueItem>> mpduList;
+      mpduList = m_low->GetMpduAggregator ()->GetNextAmpdu (mpdu, txVector, ppduDurationLimit);
+      dlOfdmaInfo.psduMap[m_candidates[i].aid] = (mpduList.size () > 1 ? Create<WifiPsdu> (mpduList)
+                                                                       : Create<WifiPsdu> (mpdu, true));
+      dlOfdmaInfo.txVector.SetHeMuUserInfo (m_candidates[i].aid, userInfo[i]);
+    }
+
+  m_edca->GetAckPolicySelector ()->UpdateTxParams (dlOfdmaInfo.psduMap, dlOfdmaInfo.params);
+  m_candidates.clear ();
+  return dlOfdmaInfo;
+}
+
+OfdmaManager::UlOfdmaInfo
+DelayAwareOfdmaManager::ComputeUlOfdmaInfo (void)
+{
+  NS_LOG_FUNCTION (this);
+  return UlOfdmaInfo ();
+}
+
+/**
+ * \param df the number of degrees of freedom
+ * \return the 97.5% quantile of the Student's t-distribution with the given
+ *         degrees of freedom (i.e., the coefficient of 95% confidence intervals)
+ */
+static double
+GetStudentT975 (uint32_t df)
+{
+  static const double quantiles[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                     2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                     2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+  if (df == 0)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  if (df <= sizeof (quantiles) / sizeof (quantiles[0]))
+    {
+      return quantiles[df - 1];
+    }
+  // large sample approximation of the quantile
+  return 1.96 + 2.4 / df;
+}
+
+/**
+ * Apply the MSER-5 truncation rule to the given samples: samples are grouped in
+ * batches of 5 and the truncation point is the number of initial batches whose
+ * removal minimizes the squared standard error of the mean of the remaining
+ * batches. Truncation points leaving fewer than 5 batches are never candidates,
+ * because the statistic is unreliable when computed on a few batches.
+ *
+ * \param samples the given samples, in time order
+ * \return the number of initial samples to discard, or -1 if the truncation point
+ *         lies in the second half of the samples (i.e., the transient may not be over)
+ */
+static int64_t
+GetMser5Truncation (const std::vector<double>& samples)
+{
+  const std::size_t batchSize = 5;
+  const std::size_t tailBatches = 5;  // min number of batches left by a truncation point
+  std::size_t nBatches = samples.size () / batchSize;
+  if (nBatches < 2 * tailBatches)
+    {
+      return -1;
+    }
+
+  std::vector<double> batches (nBatches, 0.0);
+  for (std::size_t i = 0; i < nBatches * batchSize; i++)
+    {
+      batches[i / batchSize] += samples[i] / batchSize;
+    }
+
+  // statistic of each truncation point, from sums over the remaining batches
+  std::vector<double> mser (nBatches - tailBatches + 1);
+  double sum = 0.0;
+  double sumSquares = 0.0;
+  for (std::size_t d = nBatches; d-- > 0; )
+    {
+      sum += batches[d];
+      sumSquares += batches[d] * batches[d];
+      if (d < mser.size ())
+        {
+          double m = nBatches - d;
+          mser[d] = std::max (sumSquares - sum * sum / m, 0.0) / (m * m);
+        }
+    }
+
+  std::size_t best = std::min_element (mser.begin (), mser.end ()) - mser.begin ();
+  if (best > nBatches / 2)
+    {
+      return -1;
+    }
+  return best * batchSize;
+}
+
+/**
+ * Compute the 95% confidence interval of the mean of the given samples.
+ *
+ * \param samples the given samples
+ * \param mean the sample mean
+ * \param halfWidth the half-width of the confidence interval
+ */
+static void
+GetConfidenceInterval (const std::vector<double>& samples, double& mean, double& halfWidth)
+{
+  std::size_t n = samples.size ();
+  mean = (n > 0 ? std::accumulate (samples.begin (), samples.end (), 0.0) / n : 0.0);
+  if (n < 2)
+    {
+      halfWidth = std::numeric_limits<double>::infinity ();
+      return;
+    }
+  double sumSquares = 0.0;
+  for (double sample : samples)
+    {
+      sumSquares += (sample - mean) * (sample - mean);
+    }
+  halfWidth = GetStudentT975 (n - 1) * std::sqrt (sumSquares / (n - 1) / n);
+}
+
+/**
+ * \brief Profiler of the phases of a simulation run
+ *
+ * For each phase, the profiler records the wall clock time, the simulated time and
+ * the number of simulator events executed, as well as the resident set size of the
+ * process at the end of the phase and the peak resident set size reached by the
+ * process until the end of the phase. A phase ends when the next phase starts.
+ */
+class PhaseProfiler
+{
+public:
+  PhaseProfiler ();
+  /**
+   * End the current phase, if any, and start a new phase.
+   *
+   * \param name the name of the new phase
+   */
+  void StartPhase (std::string name);
+  /**
+   * End the current phase, if any.
+   */
+  void EndPhase (void);
+  /**
+   * Print a table with the statistics of every completed phase.
+   *
+   * \param os the output stream
+   */
+  void Print (std::ostream& os) const;
+
+  /// Statistics of a phase
+  struct Phase
+  {
+    std::string name;       ///< name of the phase
+    double wallTime;        ///< wall clock duration (seconds)
+    double simTime;         ///< simulated duration (seconds)
+    uint64_t events;        ///< number of events executed
+    uint64_t rssKb;         ///< resident set size at the end of the phase (KiB)
+    uint64_t peakRssKb;     ///< peak resident set size until the end of the phase (KiB)
+  };
+  /**
+   * \return the statistics of the completed phases
+   */
+  const std::vector<Phase>& GetPhases (void) const;
+
+private:
+  /**
+   * \return the current resident set size of the process (KiB)
+   */
+  static uint64_t GetRssKb (void);
+  /**
+   * \return the peak resident set size of the process (KiB)
+   */
+  static uint64_t GetPeakRssKb (void);
+
+  std::vector<Phase> m_phases;  // completed phases
+  std::string m_current;        // name of the current phase (empty if none)
+  std::chrono::steady_clock::time_point m_wallStart;  // wall clock time when the current phase started
+  Time m_simStart;              // simulated time when the current phase started
+  uint64_t m_eventsStart;       // events executed when the current phase started
+};
+
+PhaseProfiler::PhaseProfiler ()
+  : m_simStart (Seconds (0)),
+    m_eventsStart (0)
+{
+}
+
+void
+PhaseProfiler::StartPhase (std::string name)
+{
+  EndPhase ();
+  m_current = name;
+  m_wallStart = std::chrono::steady_clock::now ();
+  m_simStart = Simulator::Now ();
+  m_eventsStart = Simulator::GetEventCount ();
+}
+
+void
+PhaseProfiler::EndPhase (void)
+{
+  if (m_current.empty ())
+    {
+      return;
+    }
+  Phase phase;
+  phase.name = m_current;
+  phase.wallTime = std::chrono::duration<double> (std::chrono::steady_clock::now () - m_wallStart).count ();
+  phase.simTime = (Simulator::Now () - m_simStart).GetSeconds ();
+  // the event count restarts when the simulator is destroyed
+  uint64_t events = Simulator::GetEventCount ();
+  phase.events = (events >= m_eventsStart ? events - m_eventsStart : events);
+  phase.rssKb = GetRssKb ();
+  phase.peakRssKb = GetPeakRssKb ();
+  m_phases.push_back (phase);
+  m_current.clear ();
+}
+
+const std::vector<PhaseProfiler::Phase>&
+PhaseProfiler::GetPhases (void) const
+{
+  return m_phases;
+}
+
+uint64_t
+PhaseProfiler::GetRssKb (void)
+{
+  std::ifstream statm ("/proc/self/statm");
+  uint64_t size = 0, resident = 0;
+  if (statm >> size >> resident)
+    {
+      return resident * (sysconf (_SC_PAGESIZE) / 1024);
+    }
+  return 0;
+}
+
+uint64_t
+PhaseProfiler::GetPeakRssKb (void)
+{
+  struct rusage usage;
+  if (getrusage (RUSAGE_SELF, &usage) == 0)
+    {
+      return usage.ru_maxrss;  // KiB on Linux
+    }
+  return 0;
+}
+
+void
+PhaseProfiler::Print (std::ostream& os) const
+{
+  os << std::endl << "Phase profile" << std::endl
+     << "-------------" << std::endl
+     << std::left << std::setw (14) << "Phase" << std::right
+     << std::setw (12) << "Wall (s)" << std::setw (12) << "Sim (s)" << std::setw (14) << "Events"
+     << std::setw (14) << "Events/s" << std::setw (12) << "Sim/Wall" << std::setw (12) << "RSS (MiB)"
+     << std::setw (12) << "Peak (MiB)" << std::endl;
+
+  double totalWall = 0.0;
+  double totalSim = 0.0;
+  uint64_t totalEvents = 0;
+  for (auto& phase : m_phases)
+    {
+      os << std::left << std::setw (14) << phase.name << std::right << std::fixed
+         << std::setprecision (3) << std::setw (12) << phase.wallTime << std::setw (12) << phase.simTime
+         << std::setw (14) << phase.events
+         << std::setprecision (0) << std::setw (14) << (phase.wallTime > 0 ? phase.events / phase.wallTime : 0.0)
+         << std::setprecision (3) << std::setw (12) << (phase.wallTime > 0 ? phase.simTime / phase.wallTime : 0.0)
+         << std::setprecision (1) << std::setw (12) << phase.rssKb / 1024. << std::setw (12) << phase.peakRssKb / 1024.
+         << std::endl;
+      totalWall += phase.wallTime;
+      totalSim += phase.simTime;
+      totalEvents += phase.events;
+    }
+  os << std::left << std::setw (14) << "Total" << std::right
+     << std::setprecision (3) << std::setw (12) << totalWall << std::setw (12) << totalSim
+     << std::setw (14) << totalEvents
+     << std::setprecision (0) << std::setw (14) << (totalWall > 0 ? totalEvents / totalWall : 0.0)
+     << std::setprecision (3) << std::setw (12) << (totalWall > 0 ? totalSim / totalWall : 0.0)
+     << std::endl << std::defaultfloat << std::setprecision (6);
+}
+
+
+/**
+ * \brief Application generating many logical flows from a single event loop
+ *
+ * Each flow is either a CBR flow, an on-off flow (CBR during the on periods) or
+ * a bulk flow (as much data as the TCP send buffer accepts). The transmission
+ * times of CBR and on-off flows are kept in a hashed timer wheel, whose slots
+ * are TimerResolution long: a single simulator event is pending at any time,
+ * which serves all the flows due in the next non-empty slot. Hence, packets are
+ * sent at multiples of the TimerResolution, but each flow keeps the exact time
+ * its next packet is due, so that its average rate is not affected by the
+ * rounding (packets due within the same slot are sent together). UDP flows
+ * share a single socket, while each TCP flow has its own connection. All the
+ * bulk flows are served by the same send callback.
+ *
+ * The Tx trace source is fired for every packet, before it is sent.
+ */
+class MultiFlowSource : public Application
+{
+public:
+  /// Flow types
+  enum FlowType
+  {
+    CBR = 0,
+    ON_OFF,
+    BULK
+  };
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  MultiFlowSource ();
+  virtual ~MultiFlowSource ();
+
+  /**
+   * Add a flow, which starts immediately if the application is running.
+   *
+   * \param type the flow type
+   * \param remote the address of the receiver
+   * \param tcp whether the flow uses TCP (bulk flows always use TCP)
+   * \param rate the data rate of CBR and on-off flows
+   * \param packetSize the packet size (the send size for bulk flows)
+   * \param onTime the duration of the on periods (on-off flows)
+   * \param offTime the duration of the off periods (on-off flows)
+   * \param maxBytes the max number of bytes to send (0 for no limit)
+   * \return the ID of the flow
+   */
+  uint32_t AddFlow (FlowType type, Address remote, bool tcp, DataRate rate, uint32_t packetSize,
+                    Time onTime = Seconds (0), Time offTime = Seconds (0), uint64_t maxBytes = 0);
+  /**
+   * \param flowId the ID of a flow
+   * \param rate the new data rate of the flow
+   */
+  void SetFlowRate (uint32_t flowId, DataRate rate);
+  /**
+   * \param flowId the ID of a flow
+   * \param packetSize the new packet size of the flow
+   */
+  void SetFlowPacketSize (uint32_t flowId, uint32_t packetSize);
+  /**
+   * \return the number of flows
+   */
+  uint32_t GetNFlows (void) const;
+  /**
+   * \param flowId the ID of a flow
+   * \return the number of packets sent by the flow
+   */
+  uint64_t GetFlowTxPackets (uint32_t flowId) const;
+  /**
+   * \param flowId the ID of a flow
+   * \return the number of bytes sent by the flow
+   */
+  uint64_t GetFlowTxBytes (uint32_t flowId) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /// A logical flow
+  struct Flow
+  {
+    FlowType type;          ///< flow type
+    Address remote;         ///< address of the receiver
+    bool tcp;               ///< whether the flow uses TCP
+    DataRate rate;          ///< data rate (CBR and on-off flows)
+    uint32_t packetSize;    ///< packet size (bytes)
+    Time onTime;            ///< duration of the on periods
+    Time offTime;           ///< duration of the off periods
+    uint64_t maxBytes;      ///< max number of bytes to send (0 for no limit)
+    Ptr<Socket> socket;     ///< TCP socket (null for UDP flows)
+    bool on;                ///< whether an on-off flow is in an on period
+    Time periodEnd;         ///< end of the current on or off period
+    Time nextTx;            ///< time the next packet is due (not rounded to the timer wheel)
+    uint64_t txPackets;     ///< packets sent
+    uint64_t txBytes;       ///< bytes sent
+  };
+
+  /**
+   * Open the socket of the given flow, if needed, and start it.
+   */
+  void StartFlow (uint32_t flowId);
+  /**
+   * Serve the given CBR or on-off flow, which is due now.
+   */
+  void ServeFlow (uint32_t flowId);
+  /**
+   * Send as much data as possible for the given bulk flow.
+   */
+  void SendBulk (uint32_t flowId);
+  /**
+   * Send a packet of the given flow.
+   *
+   * \return the number of bytes accepted by the socket
+   */
+  int SendPacket (Flow& flow, uint32_t size);
+  /**
+   * Insert the given flow in the timer wheel at the given time.
+   */
+  void ScheduleFlow (uint32_t flowId, Time at);
+  /**
+   * Serve the flows due in the current slot of the timer wheel.
+   */
+  void ProcessTick (void);
+  /**
+   * Schedule the event serving the next non-empty slot of the timer wheel.
+   */
+  void ScheduleNextTick (void);
+  /**
+   * Callback invoked when the TCP send buffer of a flow has room.
+   */
+  void DataSend (Ptr<Socket> socket, uint32_t available);
+  /**
+   * Callback invoked when the TCP connection of a flow is established.
+   */
+  void ConnectionSucceeded (Ptr<Socket> socket);
+  /**
+   * Callback invoked when the TCP connection of a flow cannot be established.
+   */
+  void ConnectionFailed (Ptr<Socket> socket);
+
+  Time m_resolution;                    // duration of a slot of the timer wheel
+  uint32_t m_wheelSize;                 // number of slots of the timer wheel
+  std::vector<Flow> m_flows;            // flows, indexed by flow ID
+  std::vector<std::vector<std::pair<uint32_t /* flow ID */, uint64_t /* tick */> > > m_wheel;  // timer wheel
+  std::size_t m_nScheduled;             // number of flows in the timer wheel
+  uint64_t m_currentTick;               // tick being processed
+  uint64_t m_nextTick;                  // tick of the pending event
+  bool m_inTick;                        // whether the flows of a tick are being served
+  EventId m_tickEvent;                  // event serving the next non-empty slot
+  Ptr<Socket> m_udpSocket;              // socket shared by UDP flows
+  std::unordered_map<Socket *, uint32_t> m_flowBySocket;  // ID of the flow of each TCP socket
+  bool m_running;                       // whether the application is running
+  TracedCallback<Ptr<const Packet> > m_txTrace;  // packets sent
+};
+
+NS_OBJECT_ENSURE_REGISTERED (MultiFlowSource);
+
+TypeId
+MultiFlowSource::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultiFlowSource")
+    .SetParent<Application> ()
+    .AddConstructor<MultiFlowSource> ()
+    .AddAttribute ("TimerResolution",
+                   "The duration of a slot of the timer wheel (CBR and on-off packets are sent "
+                   "at multiples of this duration)",
+                   TimeValue (MicroSeconds (10)),
+                   MakeTimeAccessor (&MultiFlowSource::m_resolution),
+                   MakeTimeChecker (NanoSeconds (1)))
+    .AddAttribute ("WheelSize",
+                   "The number of slots of the timer wheel",
+                   UintegerValue (4096),
+                   MakeUintegerAccessor (&MultiFlowSource::m_wheelSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddTraceSource ("Tx", "A new packet is created and is sent",
+                     MakeTraceSourceAccessor (&MultiFlowSource::m_txTrace),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+MultiFlowSource::MultiFlowSource ()
+  : m_nScheduled (0),
+    m_currentTick (0),
+    m_nextTick (std::numeric_limits<uint64_t>::max ()),
+    m_inTick (false),
+    m_running (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MultiFlowSource::~MultiFlowSource ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultiFlowSource::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  StopApplication ();
+  // flows are kept so that their counters can be retrieved
+  for (auto& flow : m_flows)
+    {
+      flow.socket = 0;
+    }
+  m_wheel.clear ();
+  m_udpSocket = 0;
+  Application::DoDispose ();
+}
+
+uint32_t
+MultiFlowSource::AddFlow (FlowType type, Address remote, bool tcp, DataRate rate, uint32_t packetSize,
+                          Time onTime, Time offTime, uint64_t maxBytes)
+{
+  NS_LOG_FUNCTION (this << type << remote << tcp << rate << packetSize << onTime << offTime << maxBytes);
+  NS_ABORT_MSG_IF (packetSize == 0, "The packet size of a flow cannot be null");
+  NS_ABORT_MSG_IF (type != BULK && rate.GetBitRate () == 0, "The data rate of a flow cannot be null");
+  Flow flow;
+  flow.type = type;
+  flow.remote = remote;
+  flow.tcp = (tcp || type == BULK);
+  flow.rate = rate;
+  flow.packetSize = packetSize;
+  flow.onTime = onTime;
+  flow.offTime = offTime;
+  flow.maxBytes = maxBytes;
+  flow.on = false;
+  flow.periodEnd = Seconds (0);
+  flow.nextTx = Seconds (0);
+  flow.txPackets = 0;
+  flow.txBytes = 0;
+  m_flows.push_back (flow);
+
+  uint32_t flowId = m_flows.size () - 1;
+  if (m_running)
+    {
+      StartFlow (flowId);
+    }
+  return flowId;
+}
+
+void
+MultiFlowSource::SetFlowRate (uint32_t flowId, DataRate rate)
+{
+  NS_ASSERT (flowId < m_flows.size () && rate.GetBitRate () > 0);
+  m_flows[flowId].rate = rate;
+}
+
+void
+MultiFlowSource::SetFlowPacketSize (uint32_t flowId, uint32_t packetSize)
+{
+  NS_ASSERT (flowId < m_flows.size () && packetSize > 0);
+  m_flows[flowId].packetSize = packetSize;
+}
+
+uint32_t
+MultiFlowSource::GetNFlows (void) const
+{
+  return m_flows.size ();
+}
+
+uint64_t
+MultiFlowSource::GetFlowTxPackets (uint32_t flowId) const
+{
+  NS_ASSERT (flowId < m_flows.size ());
+  return m_flows[flowId].txPackets;
+}
+
+uint64_t
+MultiFlowSource::GetFlowTxBytes (uint32_t flowId) const
+{
+  NS_ASSERT (flowId < m_flows.size ());
+  return m_flows[flowId].txBytes;
+}
+
+void
+MultiFlowSource::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_running = true;
+  m_wheel.assign (m_wheelSize, {});
+  m_currentTick = Simulator::Now ().GetTimeStep () / m_resolution.GetTimeStep ();
+  for (uint32_t flowId = 0; flowId < m_flows.size (); flowId++)
+    {
+      StartFlow (flowId);
+    }
+}
+
+void
+MultiFlowSource::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_running = false;
+  m_tickEvent.Cancel ();
+  m_nextTick = std::numeric_limits<uint64_t>::max ();
+  m_nScheduled = 0;
+  for (auto& slot : m_wheel)
+    {
+      slot.clear ();
+    }
+  for (auto& flow : m_flows)
+    {
+      if (flow.socket != 0)
+        {
+          flow.socket->SetSendCallback (MakeNullCallback<void, Ptr<Socket>, uint32_t> ());
+          flow.socket->Close ();
+        }
+    }
+  if (m_udpSocket != 0)
+    {
+      m_udpSocket->Close ();
+    }
+}
+
+void
+MultiFlowSource::StartFlow (uint32_t flowId)
+{
+  NS_LOG_FUNCTION (this << flowId);
+  Flow& flow = m_flows[flowId];
+
+  if (flow.tcp)
+    {
+      flow.socket = Socket::CreateSocket (GetNode (), TcpSocketFactory::GetTypeId ());
+      flow.socket->Bind ();
+      flow.socket->Connect (flow.remote);
+      flow.socket->ShutdownRecv ();
+      flow.socket->SetConnectCallback (MakeCallback (&MultiFlowSource::ConnectionSucceeded, this),
+                                       MakeCallback (&MultiFlowSource::ConnectionFailed, this));
+      m_flowBySocket[PeekPointer (flow.socket)] = flowId;
+      if (flow.type == BULK)
+        {
+          flow.socket->SetSendCallback (MakeCallback (&MultiFlowSource::DataSend, this));
+          return;
+        }
+    }
+  else if (m_udpSocket == 0)
+    {
+      m_udpSocket = Socket::CreateSocket (GetNode (), UdpSocketFactory::GetTypeId ());
+      m_udpSocket->Bind ();
+      m_udpSocket->ShutdownRecv ();
+    }
+
+  // on-off flows start with an off period, as OnOffApplication does
+  if (flow.type == ON_OFF && flow.offTime.IsStrictlyPositive ())
+    {
+      flow.on = false;
+      flow.periodEnd = Simulator::Now () + flow.offTime;
+      ScheduleFlow (flowId, flow.periodEnd);
+    }
+  else
+    {
+      flow.on = true;
+      flow.periodEnd = (flow.type == ON_OFF ? Simulator::Now () + flow.onTime : Time::Max ());
+      flow.nextTx = Simulator::Now ();
+      ScheduleFlow (flowId, flow.nextTx);
+    }
+}
+
+void
+MultiFlowSource::ServeFlow (uint32_t flowId)
+{
+  Flow& flow = m_flows[flowId];
+  Time now = Simulator::Now ();
+
+  if (flow.type == ON_OFF && now >= flow.periodEnd)
+    {
+      // switch between on and off periods. The new period starts when the previous
+      // one ended rather than at the (rounded) time the flow is served
+      Time periodStart = flow.periodEnd;
+      flow.on = !flow.on;
+      flow.periodEnd = periodStart + (flow.on ? flow.onTime : flow.offTime);
+      if (!flow.on)
+        {
+          ScheduleFlow (flowId, flow.periodEnd);
+          return;
+        }
+      flow.nextTx = periodStart;
+    }
+
+  // Send the packets due by now. Only the slot of the timer wheel is rounded, the
+  // time the next packet is due is not, hence the rate of the flow is preserved
+  do
+    {
+      if (flow.maxBytes > 0 && flow.txBytes >= flow.maxBytes)
+        {
+          return;
+        }
+      SendPacket (flow, flow.packetSize);
+      flow.nextTx += Seconds (flow.packetSize * 8. / flow.rate.GetBitRate ());
+    }
+  while (flow.nextTx <= now && flow.nextTx < flow.periodEnd);
+
+  ScheduleFlow (flowId, std::min (flow.nextTx, flow.periodEnd));
+}
+
+void
+MultiFlowSource::SendBulk (uint32_t flowId)
+{
+  Flow& flow = m_flows[flowId];
+
+  while (flow.maxBytes == 0 || flow.txBytes < flow.maxBytes)
+    {
+      uint32_t toSend = flow.packetSize;
+      if (flow.maxBytes > 0)
+        {
+          toSend = std::min<uint64_t> (toSend, flow.maxBytes - flow.txBytes);
+        }
+      if (flow.socket->GetTxAvailable () < toSend)
+        {
+          // resumed by DataSend when the send buffer has room
+          return;
+        }
+      if (SendPacket (flow, toSend) != static_cast<int> (toSend))
+        {
+          return;
+        }
+    }
+  flow.socket->Close ();
+}
+
+int
+MultiFlowSource::SendPacket (Flow& flow, uint32_t size)
+{
+  Ptr<Packet> packet = Create<Packet> (size);
+  m_txTrace (packet);
+  int sent = (flow.socket != 0 ? flow.socket->Send (packet) : m_udpSocket->SendTo (packet, 0, flow.remote));
+  if (sent > 0)
+    {
+      flow.txPackets++;
+      flow.txBytes += sent;
+    }
+  return sent;
+}
+
+void
+MultiFlowSource::ScheduleFlow (uint32_t flowId, Time at)
+{
+  // ticks are rounded up, and flows are never scheduled in the tick being served
+  int64_t res = m_resolution.GetTimeStep ();
+  uint64_t tick = (std::max (at, Simulator::Now ()).GetTimeStep () + res - 1) / res;
+  if (m_inTick)
+    {
+      tick = std::max (tick, m_currentTick + 1);
+    }
+
+  m_wheel[tick % m_wheelSize].push_back ({flowId, tick});
+  m_nScheduled++;
+
+  if (!m_inTick && tick < m_nextTick)
+    {
+      m_tickEvent.Cancel ();
+      m_nextTick = tick;
+      m_tickEvent = Simulator::Schedule (TimeStep (tick * m_resolution.GetTimeStep ()) - Simulator::Now (),
+                                         &MultiFlowSource::ProcessTick, this);
+    }
+}
+
+void
+MultiFlowSource::ProcessTick (void)
+{
+  m_currentTick = m_nextTick;
+  m_nextTick = std::numeric_limits<uint64_t>::max ();
+  m_inTick = true;
+
+  // flows due in a later revolution of the wheel stay in the slot
+  std::vector<std::pair<uint32_t, uint64_t> >& slot = m_wheel[m_currentTick % m_wheelSize];
+  std::vector<uint32_t> due;
+  for (std::size_t i = 0; i < slot.size (); )
+    {
+      if (slot[i].second == m_currentTick)
+        {
+          due.push_back (slot[i].first);
+          slot[i] = slot.back ();
+          slot.pop_back ();
+        }
+      else
+        {
+          i++;
+        }
+    }
+  m_nScheduled -= due.size ();
+
+  for (auto flowId : due)
+    {
+      ServeFlow (flowId);
+    }
+  m_inTick = false;
+  ScheduleNextTick ();
+}
+
+void
+MultiFlowSource::ScheduleNextTick (void)
+{
+  if (m_nScheduled == 0 || !m_running)
+    {
+      return;
+    }
+
+  uint64_t next = std::numeric_limits<uint64_t>::max ();
+  for (uint64_t tick = m_currentTick + 1; tick <= m_currentTick + m_wheelSize && next == std::numeric_limits<uint64_t>::max (); tick++)
+    {
+      for (auto& entry : m_wheel[tick % m_wheelSize])
+        {
+          if (entry.second == tick)
+            {
+              next = tick;
+              break;
+            }
+        }
+    }
+  if (next == std::numeric_limits<uint64_t>::max ())
+    {
+      // all the flows are due beyond a revolution of the wheel
+      for (auto& slot : m_wheel)
+        {
+          for (auto& entry : slot)
+            {
+              next = std::min (next, entry.second);
+            }
+        }
+    }
+  m_nextTick = next;
+  m_tickEvent = Simulator::Schedule (TimeStep (next * m_resolution.GetTimeStep ()) - Simulator::Now (),
+                                     &MultiFlowSource::ProcessTick, this);
+}
+
+void
+MultiFlowSource::DataSend (Ptr<Socket> socket, uint32_t available)
+{
+  auto it = m_flowBySocket.find (PeekPointer (socket));
+  if (it != m_flowBySocket.end () && m_running)
+    {
+      SendBulk (it->second);
+    }
+}
+
+void
+MultiFlowSource::ConnectionSucceeded (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  auto it = m_flowBySocket.find (PeekPointer (socket));
+  if (it != m_flowBySocket.end () && m_flows[it->second].type == BULK && m_running)
+    {
+      SendBulk (it->second);
+    }
+}
+
+void
+MultiFlowSource::ConnectionFailed (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  NS_LOG_WARN ("Connection of a flow of the multi-flow source failed");
+}
+
+
+/**
+ * \brief Application replaying the packets of a traffic trace
+ *
+ * Every record of the trace specifies the time (since the start of the application)
+ * at which a packet of the given size has to be sent to the given station. Stations
+ * are added by index; records of unknown stations are skipped. A socket is opened to
+ * each station. The packets a UDP socket cannot accept are dropped, while the records
+ * a TCP socket cannot accept are queued and sent, in order, as soon as the send
+ * buffer of the socket has room.
+ *
+ * The trace file is memory-mapped and parsed one record at a time, and the pages
+ * already replayed are released, so that traces larger than the available memory
+ * can be replayed. Two formats are supported:
+ *
+ * - binary: a 16-byte header (the "WDPT" magic, a 32-bit version and 64 reserved
+ *   bits) followed by 16-byte records, each made of a 64-bit time in nanoseconds, a
+ *   32-bit station index and a 32-bit packet size, in host byte order;
+ * - CSV: one "time (s),station,size" record per line; empty lines, lines starting
+ *   with '#' and a header line are skipped.
+ *
+ * Records must be sorted by time. Inter-packet times are multiplied by TimeScale and,
+ * if Loop is true, the trace is replayed again from the beginning once the last record
+ * has been replayed.
+ *
+ * The Tx trace source is fired for every packet the socket can accept, right before
+ * the packet is handed to the socket (so that the packet can still be tagged).
+ */
+class TraceReplayClient : public Application
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  TraceReplayClient ();
+  virtual ~TraceReplayClient ();
+
+  /// Magic number at the beginning of a binary traffic trace
+  static const char TRACE_MAGIC[4];
+  /// Version of the binary traffic trace format
+  static const uint32_t TRACE_VERSION = 1;
+  /// Size of a record of a binary traffic trace
+  static const std::size_t RECORD_SIZE = 16;
+
+  /**
+   * Add a station the trace records can refer to.
+   *
+   * \param remote the address of the receiver on the station
+   * \param socketFactory the TypeId of the factory of the socket to the station
+   * \return the index of the station in the trace
+   */
+  uint32_t AddStation (Address remote, TypeId socketFactory);
+  /**
+   * \return the number of packets sent
+   */
+  uint64_t GetTxPackets (void) const;
+  /**
+   * \return the number of bytes sent
+   */
+  uint64_t GetTxBytes (void) const;
+  /**
+   * \return the number of packets not accepted by the UDP sockets
+   */
+  uint64_t GetNDropped (void) const;
+  /**
+   * \return the number of records skipped because of an unknown station
+   */
+  uint64_t GetNSkipped (void) const;
+  /**
+   * \return the number of times the trace was replayed completely
+   */
+  uint32_t GetNLoops (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /// A record of the trace
+  struct Record
+  {
+    uint64_t timeNs;    ///< time since the beginning of the trace (ns)
+    uint32_t station;   ///< station index
+    uint32_t size;      ///< packet size (bytes)
+  };
+
+  /// A station
+  struct Station
+  {
+    Address remote;          ///< address of the receiver
+    TypeId socketFactory;    ///< TypeId of the socket factory
+    Ptr<Socket> socket;      ///< socket to the station
+    bool tcp;                ///< whether the socket is a TCP socket
+    std::deque<uint32_t> pending;  ///< sizes of the records not accepted yet by the TCP socket
+  };
+
+  /**
+   * Map the trace file and determine its format.
+   */
+  void OpenTrace (void);
+  /**
+   * Unmap the trace file.
+   */
+  void CloseTrace (void);
+  /**
+   * Parse the record at the current position of the trace and advance the position.
+   *
+   * \param record the record to fill
+   * \return false if the end of the trace has been reached
+   */
+  bool ReadRecord (Record& record);
+  /**
+   * Read the next record, rewinding the trace if needed, and schedule its transmission.
+   */
+  void ScheduleNext (void);
+  /**
+   * Send the packet of the current record.
+   */
+  void SendRecord (void);
+  /**
+   * Send a packet of the given size to the given station, if its socket can accept it.
+   *
+   * \param station the station
+   * \param size the packet size
+   * \return the number of bytes sent, or -1 if the packet was not sent
+   */
+  int SendPacket (Station& station, uint32_t size);
+  /**
+   * Send the queued records of the given station, as long as its TCP socket accepts them.
+   *
+   * \param station the station
+   */
+  void SendPending (Station& station);
+  /**
+   * Resume the transmission of the queued records when a TCP socket has room.
+   *
+   * \param socket the socket
+   * \param available the number of bytes available in the send buffer
+   */
+  void DataSend (Ptr<Socket> socket, uint32_t available);
+
+  std::string m_traceFile;      // name of the trace file
+  double m_timeScale;           // factor multiplying the inter-packet times
+  bool m_loop;                  // whether to replay the trace again once finished
+  std::vector<Station> m_stations;  // stations, indexed by station index
+  const char *m_data;           // mapped trace file
+  std::size_t m_size;           // size of the trace file
+  bool m_binary;                // whether the trace is in binary format
+  std::size_t m_begin;          // offset of the first record
+  std::size_t m_pos;            // offset of the next record
+  std::size_t m_released;       // offset up to which pages have been released
+  Record m_record;              // record to send
+  uint64_t m_lastTimeNs;        // time of the last record read in the current pass
+  uint64_t m_loopOffsetNs;      // time at which the current pass started
+  uint64_t m_nRead;             // records read in the current pass
+  Time m_start;                 // time the application started
+  EventId m_sendEvent;          // event sending the current record
+  uint64_t m_txPackets;         // packets sent
+  uint64_t m_txBytes;           // bytes sent
+  uint64_t m_nDropped;          // packets not accepted by the UDP sockets
+  uint64_t m_nSkipped;          // records of unknown stations
+  uint32_t m_nLoops;            // times the trace was replayed completely
+  std::unordered_map<Socket *, uint32_t> m_stationBySocket;  // index of the station of each TCP socket
+  TracedCallback<Ptr<const Packet> > m_txTrace;  // packets sent
+};
+
+NS_OBJECT_ENSURE_REGISTERED (TraceReplayClient);
+
+const char TraceReplayClient::TRACE_MAGIC[4] = {'W', 'D', 'P', 'T'};
+
+TypeId
+TraceReplayClient::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TraceReplayClient")
+    .SetParent<Application> ()
+    .AddConstructor<TraceReplayClient> ()
+    .AddAttribute ("TraceFile",
+                   "The name of the traffic trace file (binary or CSV)",
+                   StringValue (""),
+                   MakeStringAccessor (&TraceReplayClient::m_traceFile),
+                   MakeStringChecker ())
+    .AddAttribute ("TimeScale",
+                   "The factor multiplying the inter-packet times of the trace "
+                   "(values larger than 1 slow the trace down)",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&TraceReplayClient::m_timeScale),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("Loop",
+                   "Whether to replay the trace again once the last record has been replayed",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TraceReplayClient::m_loop),
+                   MakeBooleanChecker ())
+    .AddTraceSource ("Tx", "A new packet is created and is sent",
+                     MakeTraceSourceAccessor (&TraceReplayClient::m_txTrace),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+TraceReplayClient::TraceReplayClient ()
+  : m_data (0),
+    m_size (0),
+    m_binary (false),
+    m_begin (0),
+    m_pos (0),
+    m_released (0),
+    m_lastTimeNs (0),
+    m_loopOffsetNs (0),
+    m_nRead (0),
+    m_txPackets (0),
+    m_txBytes (0),
+    m_nDropped (0),
+    m_nSkipped (0),
+    m_nLoops (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TraceReplayClient::~TraceReplayClient ()
+{
+  NS_LOG_FUNCTION (this);
+  CloseTrace ();
+}
+
+void
+TraceReplayClient::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  StopApplication ();
+  // counters are kept so that they can be retrieved
+  for (auto& station : m_stations)
+    {
+      station.socket = 0;
+    }
+  CloseTrace ();
+  Application::DoDispose ();
+}
+
+uint32_t
+TraceReplayClient::AddStation (Address remote, TypeId socketFactory)
+{
+  NS_LOG_FUNCTION (this << remote << socketFactory);
+  m_stations.push_back ({remote, socketFactory, 0, socketFactory == TcpSocketFactory::GetTypeId (), {}});
+  return m_stations.size () - 1;
+}
+
+uint64_t
+TraceReplayClient::GetTxPackets (void) const
+{
+  return m_txPackets;
+}
+
+uint64_t
+TraceReplayClient::GetTxBytes (void) const
+{
+  return m_txBytes;
+}
+
+uint64_t
+TraceReplayClient::GetNDropped (void) const
+{
+  return m_nDropped;
+}
+
+uint64_t
+TraceReplayClient::GetNSkipped (void) const
+{
+  return m_nSkipped;
+}
+
+uint32_t
+TraceReplayClient::GetNLoops (void) const
+{
+  return m_nLoops;
+}
+
+void
+TraceReplayClient::OpenTrace (void)
+{
+  NS_LOG_FUNCTION (this);
+  int fd = open (m_traceFile.c_str (), O_RDONLY);
+  NS_ABORT_MSG_IF (fd < 0, "Cannot open traffic trace " << m_traceFile << ": " << std::strerror (errno));
+  struct stat st;
+  NS_ABORT_MSG_IF (fstat (fd, &st) != 0 || st.st_size == 0, "Empty or unreadable traffic trace " << m_traceFile);
+  m_size = st.st_size;
+  void *data = mmap (0, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  NS_ABORT_MSG_IF (data == MAP_FAILED, "Cannot map traffic trace " << m_traceFile << ": " << std::strerror (errno));
+  m_data = static_cast<const char *> (data);
+  // records are parsed in order, hence the kernel can read ahead aggressively
+  madvise (data, m_size, MADV_SEQUENTIAL);
+
+  m_binary = (m_size >= 16 && std::memcmp (m_data, TRACE_MAGIC, sizeof (TRACE_MAGIC)) == 0);
+  if (m_binary)
+    {
+      uint32_t version;
+      std::memcpy (&version, m_data + 4, sizeof (version));
+      NS_ABORT_MSG_IF (version != TRACE_VERSION, "Unsupported traffic trace version " << version);
+      m_begin = 16;
+    }
+  else
+    {
+      m_begin = 0;
+    }
+  m_pos = m_begin;
+  m_released = 0;
+}
+
+void
+TraceReplayClient::CloseTrace (void)
+{
+  if (m_data != 0)
+    {
+      munmap (const_cast<char *> (m_data), m_size);
+      m_data = 0;
+      m_size = 0;
+    }
+}
+
+bool
+TraceReplayClient::ReadRecord (Record& record)
+{
+  if (m_binary)
+    {
+      if (m_pos + RECORD_SIZE > m_size)
+        {
+          return false;
+        }
+      std::memcpy (&record.timeNs, m_data + m_pos, 8);
+      std::memcpy (&record.station, m_data + m_pos + 8, 4);
+      std::memcpy (&record.size, m_data + m_pos + 12, 4);
+      m_pos += RECORD_SIZE;
+    }
+  else
+    {
+      while (true)
+        {
+          if (m_pos >= m_size)
+            {
+              return false;
+            }
+          const char *start = m_data + m_pos;
+          const char *end = static_cast<const char *> (std::memchr (start, '\n', m_size - m_pos));
+          std::size_t length = (end != 0 ? end - start : m_size - m_pos);
+          m_pos += length + 1;
+
+          std::string line (start, length);
+          double timeS;
+          unsigned int station, size;
+          if (std::sscanf (line.c_str (), "%lf,%u,%u", &timeS, &station, &size) == 3)
+            {
+              record.timeNs = static_cast<uint64_t> (std::llround (timeS * 1e9));
+              record.station = station;
+              record.size = size;
+              break;
+            }
+          // skip empty lines, comments and the header, if any
+          std::size_t first = line.find_first_not_of (" \t\r");
+          NS_ABORT_MSG_IF (first != std::string::npos && std::isdigit (static_cast<unsigned char> (line[first])),
+                           "Malformed traffic trace record: " << line);
+        }
+    }
+
+  m_nRead++;
+
+  // release the pages already replayed, so that the memory footprint stays bounded
+  const std::size_t releaseChunk = 64 << 20;
+  if (m_pos - m_released > 2 * releaseChunk)
+    {
+      std::size_t to = (m_pos - releaseChunk) & ~(static_cast<std::size_t> (sysconf (_SC_PAGESIZE)) - 1);
+      madvise (const_cast<char *> (m_data) + m_released, to - m_released, MADV_DONTNEED);
+      m_released = to;
+    }
+  return true;
+}
+
+void
+TraceReplayClient::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (m_traceFile.empty (), "No traffic trace to replay");
+  for (uint32_t i = 0; i < m_stations.size (); i++)
+    {
+      Station& station = m_stations[i];
+      station.socket = Socket::CreateSocket (GetNode (), station.socketFactory);
+      station.socket->Bind ();
+      station.socket->Connect (station.remote);
+      station.socket->ShutdownRecv ();
+      if (station.tcp)
+        {
+          station.socket->SetSendCallback (MakeCallback (&TraceReplayClient::DataSend, this));
+          m_stationBySocket[PeekPointer (station.socket)] = i;
+        }
+    }
+  OpenTrace ();
+  m_start = Simulator::Now ();
+  m_loopOffsetNs = 0;
+  m_lastTimeNs = 0;
+  m_nRead = 0;
+  ScheduleNext ();
+}
+
+void
+TraceReplayClient::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_sendEvent.Cancel ();
+  for (auto& station : m_stations)
+    {
+      if (station.socket != 0)
+        {
+          station.socket->SetSendCallback (MakeNullCallback<void, Ptr<Socket>, uint32_t> ());
+          station.socket->Close ();
+        }
+      station.pending.clear ();
+    }
+  m_stationBySocket.clear ();
+}
+
+void
+TraceReplayClient::ScheduleNext (void)
+{
+  if (!ReadRecord (m_record))
+    {
+      if (!m_loop)
+        {
+          return;
+        }
+      NS_ABORT_MSG_IF (m_nRead == 0, "The traffic trace " << m_traceFile << " has no records");
+      NS_ABORT_MSG_IF (m_lastTimeNs == 0, "Cannot loop a traffic trace lasting no time");
+      m_nLoops++;
+      m_loopOffsetNs += m_lastTimeNs;
+      m_lastTimeNs = 0;
+      m_nRead = 0;
+      madvise (const_cast<char *> (m_data), m_size, MADV_SEQUENTIAL);
+      m_pos = m_begin;
+      m_released = 0;
+      bool found = ReadRecord (m_record);
+      NS_ASSERT (found);
+    }
+
+  // records out of order are sent immediately
+  m_lastTimeNs = std::max (m_lastTimeNs, m_record.timeNs);
+  Time at = m_start + NanoSeconds (static_cast<int64_t> ((m_loopOffsetNs + m_lastTimeNs) * m_timeScale));
+  m_sendEvent = Simulator::Schedule (std::max (at - Simulator::Now (), Seconds (0)),
+                                     &TraceReplayClient::SendRecord, this);
+}
+
+void
+TraceReplayClient::SendRecord (void)
+{
+  if (m_record.station >= m_stations.size ())
+    {
+      m_nSkipped++;
+    }
+  else
+    {
+      Station& station = m_stations[m_record.station];
+      if (station.tcp)
+        {
+          station.pending.push_back (m_record.size);
+          SendPending (station);
+        }
+      else if (SendPacket (station, m_record.size) < 0)
+        {
+          m_nDropped++;
+        }
+    }
+  ScheduleNext ();
+}
+
+int
+TraceReplayClient::SendPacket (Station& station, uint32_t size)
+{
+  if (station.socket->GetTxAvailable () < size)
+    {
+      return -1;
+    }
+  Ptr<Packet> packet = Create<Packet> (size);
+  m_txTrace (packet);
+  int sent = station.socket->Send (packet);
+  if (sent >= 0)
+    {
+      m_txPackets++;
+      m_txBytes += size;
+    }
+  return sent;
+}
+
+void
+TraceReplayClient::SendPending (Station& station)
+{
+  while (!station.pending.empty () && SendPacket (station, station.pending.front ()) >= 0)
+    {
+      station.pending.pop_front ();
+    }
+}
+
+void
+TraceReplayClient::DataSend (Ptr<Socket> socket, uint32_t available)
+{
+  auto it = m_stationBySocket.find (PeekPointer (socket));
+  if (it != m_stationBySocket.end ())
+    {
+      SendPending (m_stations[it->second]);
+    }
+}
+
+
+
+/**
+ * \brief Pool of worker processes running jobs identified by an index
+ *
+ * At most a given number of workers run at the same time. Each worker is a forked
+ * copy of the calling process whose standard output and error are redirected to a
+ * log file. The caller runs the job in the worker and then either terminates the
+ * worker with Exit () or, as the variants do, returns to the simulation.
+ */
+class WorkerPool
+{
+public:
+  /**
+   * Create a pool of worker processes.
+   *
+   * \param nJobs the maximum number of concurrent workers (0 means one per core)
+   */
+  WorkerPool (uint32_t nJobs);
+  /**
+   * \return the maximum number of concurrent workers
+   */
+  uint32_t GetNJobs (void) const;
+  /**
+   * \return true if a new worker can be started without exceeding the job limit
+   */
+  bool CanSpawn (void) const;
+  /**
+   * \return true if no worker is running
+   */
+  bool IsIdle (void) const;
+  /**
+   * Fork a worker for the given job. In the worker, standard output and error are
+   * redirected to the given log file.
+   *
+   * \param job the index of the job
+   * \param logFile the name of the log file of the worker
+   * \return true in the worker process, false in the calling process
+   */
+  bool Spawn (std::size_t job, const std::string& logFile);
+  /**
+   * Wait for a worker to terminate.
+   *
+   * \param job set to the index of the job of the terminated worker
+   * \return true if the worker exited successfully
+   */
+  bool Reap (std::size_t& job);
+  /**
+   * Terminate the worker process.
+   *
+   * \param success whether the job of the worker succeeded
+   */
+  static void Exit (bool success);
+
+private:
+  uint32_t m_nJobs;                        // maximum number of concurrent workers
+  std::map<pid_t, std::size_t> m_running;  // PID of the worker -> index of the job
+};
+
+WorkerPool::WorkerPool (uint32_t nJobs)
+  : m_nJobs (nJobs)
+{
+  if (m_nJobs == 0)
+    {
+      long nCores = sysconf (_SC_NPROCESSORS_ONLN);
+      m_nJobs = (nCores > 0 ? nCores : 1);
+    }
+}
+
+uint32_t
+WorkerPool::GetNJobs (void) const
+{
+  return m_nJobs;
+}
+
+bool
+WorkerPool::CanSpawn (void) const
+{
+  return m_running.size () < m_nJobs;
+}
+
+bool
+WorkerPool::IsIdle (void) const
+{
+  return m_running.empty ();
+}
+
+bool
+WorkerPool::Spawn (std::size_t job, const std::string& logFile)
+{
+  // do not let the worker inherit (and flush again) buffered output
+  std::cout.flush ();
+  std::cerr.flush ();
+  fflush (nullptr);
+
+  pid_t pid = fork ();
+  NS_ABORT_MSG_IF (pid < 0, "Cannot fork a worker: " << std::strerror (errno));
+  if (pid > 0)
+    {
+      m_running[pid] = job;
+      return false;
+    }
+
+  m_running.clear ();
+  int fd = open (logFile.c_str (), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd >= 0)
+    {
+      dup2 (fd, STDOUT_FILENO);
+      dup2 (fd, STDERR_FILENO);
+      close (fd);
+    }
+  return true;
+}
+
+bool
+WorkerPool::Reap (std::size_t& job)
+{
+  NS_ASSERT (!m_running.empty ());
+  while (true)
+    {
+      int status;
+      pid_t pid = waitpid (-1, &status, 0);
+      if (pid < 0)
+        {
+          NS_ABORT_MSG_IF (errno != EINTR, "waitpid() failed: " << std::strerror (errno));
+          continue;
+        }
+      auto it = m_running.find (pid);
+      if (it == m_running.end ())
+        {
+          continue;
+        }
+      job = it->second;
+      m_running.erase (it);
+      return WIFEXITED (status) && WEXITSTATUS (status) == EXIT_SUCCESS;
+    }
+}
+
+void
+WorkerPool::Exit (bool success)
+{
+  std::cout.flush ();
+  std::cerr.flush ();
+  _exit (success ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+/**
+ * \brief Example to test DL OFDMA
+ *
+ * Usage: ./waf --run "wifi-dl-ofdma [options]" > results.log
+ *
+ * To extract the list of space-separated throughput values:
+ *
+ * grep -A 2 Throughput results.log | grep STA_ | sed 's/STA_[0-9]*: //g'
+ *
+ * Similarly, it is possible to extract the list of per-station TX failures
+ * (grep -A 2 failures...) and expired MSDUs (grep -A 2 Expired...)
+ *
+ * Alternatively, a record with the configuration and all the per-station and
+ * aggregate results of the run can be appended to a JSON Lines and/or CSV file:
+ *
+ * ./waf --run "wifi-dl-ofdma --resultsJson=results.jsonl --resultsCsv=results.csv [options]"
+ *
+ * The evolution of the per-station statistics and of the AP queue from the start
+ * of the traffic to the end of the measurement period can be sampled periodically:
+ *
+ * ./waf --run "wifi-dl-ofdma --sampleInterval=10 --timeSeriesFile=ts.csv [options]"
+ *
+ * Flow monitor statistics are written to an XML file by default. They can be
+ * written to a CSV file instead (one row per flow), or the flow monitor can be
+ * disabled entirely. Histograms and per-probe statistics can be left out of the
+ * output, but the flow monitor still maintains them while running; only
+ * flowMonitor=None removes the runtime cost of the probes:
+ *
+ * ./waf --run "wifi-dl-ofdma --flowMonitor=Csv --flowMonitorFile=flows.csv --flowMonitorProbes=0 [options]"
+ *
+ * Variants differing only in the settings of the measurement period can share
+ * association and warmup: the simulation forks a child process per variant
+ * when statistics start (see WifiDlOfdmaExample::ForkVariants):
+ *
+ * ./waf --run "wifi-dl-ofdma --variants=txopLimit=2000;txopLimit=5440,dataRate=20 [options]"
+ *
+ * The measurement period can be ended (and the simulation stopped) as soon as the
+ * batch means of throughput and latency converge, simulationTime being the maximum
+ * duration of the measurement period:
+ *
+ * ./waf --run "wifi-dl-ofdma --targetPrecision=0.02 --batchDuration=100 [options]"
+ *
+ * To run independent replications on all the local cores and summarize their
+ * results with confidence intervals (see WifiDlOfdmaReplications):
+ *
+ * ./waf --run "wifi-dl-ofdma --replications=20 --replicationPrecision=0.05 [options]"
+ *
+ * To run the performance benchmark and compare it against a stored baseline (see
+ * WifiDlOfdmaBenchmark):
+ *
+ * ./waf --run "wifi-dl-ofdma --benchmark=baseline.csv --benchmarkThreshold=0.1 --simulationTime=0.5"
+ *
+ * The default benchmark grid is small; the full grid is run with --benchmarkFullGrid=1.
+ *
+ * To run a parameter sweep on all the local cores (see WifiDlOfdmaSweep):
+ *
+ * ./waf --run "wifi-dl-ofdma --sweep=sweep.txt --sweepOutput=results [options]"
+ *
+ * Stations associate one at a time by default. To speed up the setup of large
+ * networks, stations can associate in batches and ARP caches can be populated
+ * in advance:
+ *
+ * ./waf --run "wifi-dl-ofdma --assocBatchSize=20 --staticArp=1 [options]"
+ *
+ * The warmup period lasts warmup seconds by default. Alternatively, it can end as
+ * soon as the MSER-5 rule detects the end of the transient of throughput and AP
+ * queue occupancy, in which case warmup is the minimum duration of the warmup period
+ * and maxWarmup (simulationTime, if zero) is its maximum duration:
+ *
+ * ./waf --run "wifi-dl-ofdma --adaptiveWarmup=1 --warmupSampleInterval=10 --warmup=1 --maxWarmup=10 [options]"
+ *
+ * The AP uses the round-robin OFDMA manager by default. To serve the stations
+ * receiving the voice-like flows (the odd stations) first, with RUs sized to the
+ * backlog of the stations (see DelayAwareOfdmaManager):
+ *
+ * ./waf --run "wifi-dl-ofdma --ofdmaManager=DelayAware --delayBudget=20 [options]"
+ *
+ * The traffic of all the stations can be generated by a single application on the
+ * AP, rather than by one client application per station (see MultiFlowSource):
+ *
+ * ./waf --run "wifi-dl-ofdma --multiFlowSource=1 [options]"
+ *
+ * Alternatively, the downlink traffic can be replayed from a (binary or CSV) packet
+ * trace listing the time, the station index and the size of every packet (see
+ * TraceReplayClient):
+ *
+ * ./waf --run "wifi-dl-ofdma --trafficTrace=load.csv --traceTimeScale=1 --traceLoop=1 [options]"
+ *
+ * A binary trace of the PPDUs, MSDU dequeues, expired MSDUs and TX failures of the
+ * measurement period can be written, so that the statistics can be recomputed (or
+ * new ones computed) later without simulating again (see WifiDlOfdmaTraceReader):
+ *
+ * ./waf --run "wifi-dl-ofdma --traceFile=run.trace [options]"
+ * ./waf --run "wifi-dl-ofdma --readTrace=run.trace"
+ *
+ * Many short scenarios can be run one after another in the same process (see
+ * WifiDlOfdmaScenario):
+ *
+ * ./waf --run "wifi-dl-ofdma --scenarios=scenarios.txt --scenarioOutput=results.csv [options]"
+ */
+class WifiDlOfdmaExample
+{
+public:
+  /**
+   * Create an example instance.
+   */
+  WifiDlOfdmaExample ();
+  /**
+   * Set the stream the output of the example (progress and results) is written to.
+   * The default is std::cout. Must be called before Config.
+   *
+   * \param os the output stream
+   */
+  void SetOutputStream (std::ostream& os);
+  /**
+   * Parse the options provided through command line.
+   */
+  void Config (int argc, char *argv[]);
+  /**
+   * Prefix the base names of the flow monitor file and of the binary trace with
+   * the given prefix, so that concurrent runs (e.g., sweep workers or variants)
+   * do not overwrite each other's files. Must be called before Setup.
+   *
+   * \param prefix the given prefix (e.g., "results/point-00001")
+   */
+  void RenameOutputFiles (const std::string& prefix);
+  /**
+   * Setup nodes, devices and internet stacks.
+   */
+  void Setup (void);
+  /**
+   * Run simulation and print results.
+   */
+  void Run (void);
+  /**
+   * Write the statistics collected by the flow monitor in the configured format.
+   *
+   * \param monitor the flow monitor
+   * \param classifier the classifier mapping flow IDs to five-tuples
+   */
+  void ExportFlowStats (Ptr<FlowMonitor> monitor, Ptr<Ipv4FlowClassifier> classifier) const;
+  /**
+   * Make the next batch of stations associate with the AP.
+   */
+  void StartAssociation (void);
+  /**
+   * Make the AP establish a BA agreement with the given station, which just associated.
+   */
+  void EstablishBaAgreement (std::size_t staId, Mac48Address bssid);
+  /**
+   * Add permanent entries to the ARP caches of the AP and of the stations.
+   */
+  void PopulateArpCaches (void);
+  /**
+   * Start an OnOff client application for the given station.
+   */
+  void StartOnOffClient (std::size_t staId, OnOffHelper client);         //jaishreeram from StartClient to StartOnOffClient
+  /**
+   * Start a BulkSend client application for the given station.
+   */
+  void StartBulkSendClient (std::size_t staId, BulkSendHelper client);   //jaishreeram
+  /**
+   * Add the flow of the given station to the multi-flow source of the AP.
+   */
+  void AddSourceFlow (std::size_t staId);
+  /**
+   * Start generating traffic.
+   */
+  void StartTraffic (void);
+  /**
+   * Start collecting statistics.
+   */
+  void StartStatistics (void);
+  /**
+   * Stop collecting statistics.
+   */
+  void StopStatistics (void);
+  /**
+   * Start sampling throughput and queue occupancy to detect the end of the warmup period.
+   */
+  void StartWarmupDetection (void);
+  /**
+   * Take a sample of throughput and queue occupancy and check whether the warmup
+   * period is over.
+   */
+  void SampleWarmup (void);
+  /**
+   * End the warmup period and start collecting statistics.
+   *
+   * \param truncation the MSER-5 truncation point (negative if not detected)
+   */
+  void EndWarmup (Time truncation);
+  /**
+   * Return the number of bytes received by all the stations so far.
+   */
+  uint64_t GetTotalRxBytes (void) const;
+  /**
+   * Return the maximum duration of the warmup period (seconds).
+   */
+  double GetMaxWarmup (void) const;
+  /**
+   * Fork a child process for each variant, wait for all of them to complete and
+   * stop the simulation in the parent process. Child processes return to the
+   * simulation and run the measurement period of their variant.
+   */
+  void ForkVariants (void);
+  /**
+   * Apply the settings of the given variant in the child process running it.
+   *
+   * \param index the index of the variant
+   */
+  void StartVariant (std::size_t index);
+  /**
+   * \param index the index of a variant
+   * \param extension the extension of the file
+   * \return the name of the file in the variant output directory associated with the variant
+   */
+  std::string GetVariantFileName (std::size_t index, std::string extension) const;
+  /**
+   * End the current batch of the measurement period and stop collecting
+   * statistics if the batch means converged to the target precision.
+   */
+  void EndBatch (void);
+  /**
+   * Start sampling the per-station and AP queue statistics periodically.
+   */
+  void StartSampling (void);
+  /**
+   * Write the statistics of the window that just ended to the time series file.
+   */
+  void Sample (void);
+  /**
+   * Stop sampling the statistics periodically.
+   */
+  void StopSampling (void);
+  /**
+   * Count an MPDU that was not correctly received in the current sampling window.
+   */
+  void SampleTxFailed (const WifiMacHeader& hdr);
+  /**
+   * Count an expired MSDU in the current sampling window.
+   */
+  void SampleMsduExpired (Ptr<const WifiMacQueueItem> item);
+  /**
+   * Count a TXOP in the current sampling window. TxopTrace fires when a TXOP
+   * ends, hence TXOPs are counted, with their whole duration, in the window in
+   * which they end (a TXOP spanning a window boundary is entirely accounted to
+   * the later window).
+   */
+  void SampleTxop (Time startTime, Time duration);
+  /**
+   * Report that an MPDU was not correctly received.
+   */
+  void NotifyTxFailed (const WifiMacHeader& hdr);
+  /**
+   * Report that the lifetime of an MSDU expired.
+   */
+  void NotifyMsduExpired (Ptr<const WifiMacQueueItem> item);
+  /**
+   * Report that an MSDU was dequeued from the EDCA queue.
+   */
+  void NotifyMsduDequeuedFromEdcaQueue (Ptr<const WifiMacQueueItem> item);
+  /**
+   * Report that PSDUs were forwarded down to the PHY.
+   */
+  void NotifyPsduForwardedDown (WifiPsduMap psduMap, WifiTxVector txVector);
+  /**
+   * Charge the airtime of the given PPDU to the categories of channel time and
+   * to the stations it is addressed to (or sent by).
+   *
+   * \param psduMap the PSDUs carried by the PPDU
+   * \param txVector the TX vector of the PPDU
+   * \return the duration of the PPDU
+   */
+  Time ChargeAirtime (const WifiPsduMap& psduMap, const WifiTxVector& txVector);
+  /**
+   * Append the records of the given PPDU to the binary trace.
+   *
+   * \param psduMap the PSDUs carried by the PPDU
+   * \param txVector the TX vector of the PPDU
+   * \param duration the duration of the PPDU
+   */
+  void TracePpdu (const WifiPsduMap& psduMap, const WifiTxVector& txVector, Time duration);
+  /**
+   * Append a record not related to a PPDU to the binary trace.
+   *
+   * \param type the type of the record
+   * \param address the MAC address of the station the record refers to
+   * \param value the value of the record
+   */
+  void TraceEvent (TraceRecord::Type type, Mac48Address address, int64_t value = 0);
+  /**
+   * \param category a category of channel time
+   * \return the name of the given category
+   */
+  static const char *GetAirtimeCategoryName (std::size_t category);
+  /**
+   * \return Jain's fairness index of the airtime charged to the stations
+   */
+  double GetAirtimeFairness (void) const;
+  /**
+   * Report that an MPDU was not correctly received.
+   */
+  void TxopDuration (Time startTime, Time duration);
+  /**
+   * Report that the MAC of the AP has received a new packet from the upper layers.
+   */
+  void NotifyApplicationTx (Ptr<const Packet> p);
+  /**
+   * Report that the MAC of the given station has forwarded a new packet up.
+   */
+  void NotifyApplicationRx (std::size_t staId, Ptr<const Packet> p);
+  /**
+   * Return the index of the station having the given MAC address.
+   */
+  std::size_t GetStaIndex (Mac48Address address) const;
+  /**
+   * Return the index of the station having the given association ID.
+   */
+  std::size_t GetStaIndexByAid (uint16_t aid) const;
+  /**
+   * Stamp the current time on a packet sent by a client application.
+   */
+  void StampApplicationTx (Ptr<const Packet> p);
+  /**
+   * Report that the packet sink of the given station has received a packet.
+   */
+  void NotifySinkRx (std::size_t staId, Ptr<const Packet> p);
+  /**
+   * Collect the configuration and the per-station and aggregate results of the run.
+   *
+   * \param overallLatency the latency samples of all the stations
+   */
+  void CollectResults (const LatencyHistogram& overallLatency);
+  /**
+   * Append the collected results of the run to the given JSON Lines file.
+   *
+   * \param fileName the name of the file
+   */
+  void WriteJsonResults (const std::string& fileName) const;
+  /**
+   * Append the collected results of the run to the given CSV file.
+   *
+   * \param fileName the name of the file
+   */
+  void WriteCsvResults (const std::string& fileName) const;
+  /**
+   * Return the name of the file describing the parameter sweep to run, if any.
+   */
+  std::string GetSweepFile (void) const;
+  /**
+   * Return the maximum number of concurrent sweep workers (0 means one per core).
+   */
+  uint32_t GetSweepJobs (void) const;
+  /**
+   * Return the directory storing the results of the parameter sweep.
+   */
+  std::string GetSweepOutput (void) const;
+  /**
+   * Return the comma separated names of the fields returned by GetSummary.
+   */
+  static std::string GetSummaryHeader (void);
+  /**
+   * Return a comma separated summary of the results of the last run.
+   */
+  std::string GetSummary (void) const;
+  /**
+   * Return the binary trace to recompute the statistics from, if any.
+   */
+  std::string GetReadTrace (void) const;
+  /**
+   * Return the file storing the benchmark baseline, if a benchmark is to be run.
+   */
+  std::string GetBenchmark (void) const;
+  /**
+   * Return the file listing the parameter grids of the benchmark (empty for a built-in grid).
+   */
+  std::string GetBenchmarkGrid (void) const;
+  /**
+   * Return whether the built-in benchmark grid is the full grid rather than the default one.
+   */
+  bool GetBenchmarkFullGrid (void) const;
+  /**
+   * Return the maximum relative slowdown with respect to the benchmark baseline.
+   */
+  double GetBenchmarkThreshold (void) const;
+  /**
+   * Return the maximum relative drop of the events per second with respect to the benchmark baseline.
+   */
+  double GetBenchmarkEventsThreshold (void) const;
+  /**
+   * Return the maximum relative growth of the peak memory with respect to the benchmark baseline.
+   */
+  double GetBenchmarkRssThreshold (void) const;
+  /**
+   * Return the relative change of the throughput with respect to the benchmark baseline
+   * above which a point is flagged.
+   */
+  double GetBenchmarkThroughputThreshold (void) const;
+  /**
+   * Return whether the benchmark results are to be stored as the new baseline.
+   */
+  bool GetBenchmarkUpdate (void) const;
+  /**
+   * Return the number of concurrent benchmark workers.
+   */
+  uint32_t GetBenchmarkJobs (void) const;
+  /**
+   * Return the directory storing the benchmark results.
+   */
+  std::string GetBenchmarkOutput (void) const;
+  /**
+   * Return the maximum number of independent replications to run (0 means a single run).
+   */
+  uint32_t GetReplications (void) const;
+  /**
+   * Return the minimum number of replications before checking the precision.
+   */
+  uint32_t GetMinReplications (void) const;
+  /**
+   * Return the relative CI half-width at which replications stop (0 means run all of them).
+   */
+  double GetReplicationPrecision (void) const;
+  /**
+   * Return the maximum number of concurrent replications (0 means one per core).
+   */
+  uint32_t GetReplicationJobs (void) const;
+  /**
+   * Return the directory storing the results of the replications.
+   */
+  std::string GetReplicationOutput (void) const;
+  /**
+   * Return the file listing the scenarios to run in this process, if any.
+   */
+  std::string GetScenarios (void) const;
+  /**
+   * Return the CSV file the summaries of the scenarios are appended to.
+   */
+  std::string GetScenarioOutput (void) const;
+  /**
+   * Return the number of measurement period variants.
+   */
+  std::size_t GetNVariants (void) const;
+  /**
+   * Return the aggregate results of the last run.
+   */
+  const std::vector<std::pair<std::string, double> >& GetAggregateResults (void) const;
+  /**
+   * Return the per-station results of the last run.
+   */
+  const std::vector<std::pair<std::string, std::vector<double> > >& GetStaResults (void) const;
+
+private:
+  uint32_t m_payloadSize;   // bytes
+  double m_simulationTime;  // seconds
+  uint16_t m_nStations;     // not including AP
+  double m_radius;          // meters
+  bool m_enableDlOfdma;
+  bool m_forceDlOfdma;
+  bool m_enableUlOfdma;
+  uint32_t m_ulPsduSize;
+  uint16_t m_channelWidth;  // channel bandwidth
+  uint8_t m_channelNumber;
+  uint16_t m_channelCenterFrequency;
+  uint16_t m_guardInterval; // GI in nanoseconds
+  uint8_t m_maxNRus;        // max number of RUs per MU PPDU
+  std::string m_ofdmaManager;  // OFDMA manager of the AP (Rr or DelayAware)
+  double m_delayBudget;     // delay budget of latency-sensitive stations (ms)
+  uint32_t m_mcs;           // MCS value
+  uint16_t m_maxAmsduSize;  // maximum A-MSDU size
+  uint32_t m_maxAmpduSize;  // maximum A-MSDU size
+  double m_txopLimit;       // microseconds
+  uint32_t m_macQueueSize;  // packets
+  uint32_t m_msduLifetime;  // milliseconds
+  bool m_enableRts;
+  double m_dataRate;        // Mb/s
+  uint16_t m_dlAckSeqType;
+  bool m_continueTxop;
+  uint16_t m_baBufferSize;
+  std::string m_transport;
+  std::string m_queueDisc;
+  bool m_cacheLinkGains;    // precompute the gains and delays of all the links
+  bool m_cacheTxDurations;  // look up the durations of PPDUs and TF UL Lengths
+  TxDurationCache m_txDurationCache; // durations of PPDUs and TF UL Lengths
+  std::string m_flowMonitor; // format of the flow monitor statistics (Xml, Csv or None)
+  std::string m_flowMonitorFile;  // file storing the flow monitor statistics
+  bool m_flowMonitorHistograms;   // include histograms in the flow monitor statistics
+  bool m_flowMonitorProbes;       // include per-probe flow monitor statistics
+  bool m_enablePcap;
+  double m_warmup;          // duration (minimum duration, if adaptive) of the warmup period (seconds)
+  double m_maxWarmup;       // maximum duration of the adaptive warmup period (seconds, 0 for simulationTime)
+  bool m_adaptiveWarmup;    // detect the end of the warmup period with MSER-5
+  uint32_t m_warmupSampleInterval;  // interval between warmup samples (milliseconds)
+  Time m_trafficStart;      // time traffic was started
+  uint64_t m_warmupRx;      // bytes received by all the stations at the last warmup sample
+  std::vector<double> m_warmupTput;   // throughput samples of the warmup period (Mb/s)
+  std::vector<double> m_warmupQueue;  // AP BE queue occupancy samples of the warmup period (packets)
+  EventId m_warmupSampleEvent;        // next warmup sample
+  EventId m_warmupTimeoutEvent;       // end of the warmup period, if not detected earlier
+  double m_warmupDuration;  // duration of the warmup period (seconds)
+  double m_mserTruncation;  // MSER-5 truncation point (seconds since traffic start, -1 if not detected)
+  std::size_t m_currentSta; // index of the next station to associate
+  uint16_t m_assocBatchSize; // number of stations associating at the same time
+  std::size_t m_nAssocPending; // stations of the current batch that did not associate yet
+  bool m_staticArp;         // populate the ARP caches instead of resolving addresses
+  Time m_setupDuration;     // simulated duration of the association phase
+  std::chrono::steady_clock::time_point m_runStartWallTime;  // wall clock time when Run() started
+  double m_setupWallTime;   // wall clock duration of the association phase (seconds)
+  PhaseProfiler m_profiler; // profiler of the phases of the run
+  Ssid m_ssid;
+  NodeContainer m_apNodes;
+  NodeContainer m_staNodes;
+  NetDeviceContainer m_staDevices;
+  NetDeviceContainer m_apDevices;
+  Ipv4InterfaceContainer m_staInterfaces;
+  ApplicationContainer m_sinkApps;
+  ApplicationContainer m_sinkApps_bulk;
+  ApplicationContainer m_clientApps;
+  ApplicationContainer m_clientApps_bulk;   //added this jaishreeram
+  std::vector<Ptr<Application> > m_staClientApps;  // client application of each station (station index)
+  bool m_multiFlowSource;                // generate the traffic of all the stations with a single application
+  Ptr<MultiFlowSource> m_source;         // multi-flow source of the AP
+  std::vector<uint32_t> m_staFlows;      // ID of the flow of each station in the multi-flow source
+  std::vector<uint64_t> m_sourceTxPackets;  // packets sent by each flow of the multi-flow source
+  std::vector<uint64_t> m_sourceTxBytes;    // bytes sent by each flow of the multi-flow source
+  std::string m_trafficTrace;            // packet trace replayed by the AP (empty to use client applications)
+  double m_traceTimeScale;               // factor multiplying the inter-packet times of the trace
+  bool m_traceLoop;                      // replay the packet trace again once finished
+  Ptr<TraceReplayClient> m_replay;       // application replaying the packet trace
+  uint16_t m_port;
+  uint16_t m_port_bulk; //port for bulksendapp jaishreeram
+  Time m_maxTxop;
+  std::vector<uint64_t> m_rxStart, m_rxStop;
+  WifiDlOfdmaStats m_stats;  // DL and UL statistics of the measurement period
+  std::map <uint64_t /* uid */, Time /* start */> m_appPacketTxMap;
+  std::map <uint32_t /* nodeId */, LatencyHistogram> m_appLatencyMap;
+  uint64_t m_nextWriteId;    // identifier of the next application write stamped with an AppTxTimeTag
+  std::unordered_map<uint64_t /* write ID */, uint32_t /* bytes */> m_partialWrites;  // bytes received of incomplete writes
+  std::string m_latencyMode; // App (packet sink to client application) or Mac (MacRx to MacTx)
+  bool m_verbose;
+  std::ostream *m_os;       // stream the output of the example is written to
+  std::string m_sweepFile;  // file describing the parameter sweep
+  uint32_t m_sweepJobs;     // max number of concurrent sweep workers
+  std::string m_sweepOutput; // directory storing the sweep results
+  std::string m_summary;    // summary of the results of the last run
+  std::string m_benchmark;  // file storing the benchmark baseline
+  std::string m_benchmarkGrid; // file listing the parameter grids of the benchmark
+  bool m_benchmarkFullGrid; // run the full built-in benchmark grid
+  double m_benchmarkThreshold; // max relative slowdown with respect to the baseline
+  double m_benchmarkEventsThreshold; // max relative drop of the events per second with respect to the baseline
+  double m_benchmarkRssThreshold; // max relative growth of the peak memory with respect to the baseline
+  double m_benchmarkThroughputThreshold; // relative throughput change flagged with respect to the baseline
+  bool m_benchmarkUpdate;   // store the benchmark results as the new baseline
+  uint32_t m_benchmarkJobs; // number of concurrent benchmark workers
+  std::string m_benchmarkOutput; // directory storing the benchmark results
+  uint32_t m_replications;  // max number of independent replications
+  uint32_t m_minReplications; // min number of replications before checking the precision
+  double m_replicationPrecision; // relative CI half-width at which replications stop
+  uint32_t m_replicationJobs; // max number of concurrent replications
+  std::string m_replicationOutput; // directory storing the results of the replications
+  std::string m_scenarios;        // file listing the scenarios to run in this process
+  std::string m_scenarioOutput;   // CSV file the summaries of the scenarios are appended to
+  std::string m_variantSpec; // measurement period variants (as given on the command line)
+  std::vector<std::string> m_variants;  // measurement period variants
+  std::vector<std::vector<std::pair<std::string, std::string> > > m_variantList;  // settings of each variant
+  uint32_t m_variantJobs;   // max number of concurrent variants
+  std::string m_variantOutput; // directory storing the variant results
+  std::size_t m_variantIndex; // index of the variant run by this process
+  static const std::size_t VARIANT_NONE = ~static_cast<std::size_t> (0);  // variants are not used
+  static const std::size_t VARIANT_PARENT = VARIANT_NONE - 1;  // process that forked the variants
+  std::string m_resultsJson; // JSON Lines file the results are appended to
+  std::string m_resultsCsv; // CSV file the results are appended to
+  std::vector<std::pair<std::string, std::string> > m_configFields;  // configuration of the run
+  std::vector<std::pair<std::string, double> > m_aggregateResults;   // aggregate results of the run
+  std::vector<std::pair<std::string, std::vector<double> > > m_staResults;  // per-station results of the run
+  double m_targetPrecision;         // relative CI half-width ending the measurement period (0 disables)
+  double m_batchDuration;           // duration of a batch of the measurement period (milliseconds)
+  uint32_t m_minBatches;            // minimum number of batches before checking convergence
+  bool m_converged;                 // whether the measurement period ended because results converged
+  Time m_statisticsStart;           // start time of the measurement period
+  EventId m_stopStatisticsEvent;    // event ending the measurement period
+  EventId m_batchEvent;             // event ending the current batch
+  std::vector<double> m_batchTput;  // total throughput of each batch (Mb/s)
+  std::vector<double> m_batchLatency;  // average latency of each batch (ms)
+  uint64_t m_batchRx;               // total bytes received until the end of the last batch
+  double m_batchLatencySum;         // sum of the latency samples until the end of the last batch (ms)
+  uint64_t m_batchLatencyCount;     // number of latency samples until the end of the last batch
+  double m_sampleInterval;          // milliseconds (0 disables the time series)
+  std::string m_timeSeriesFile;     // file storing the time series
+  std::ofstream m_timeSeries;       // stream writing the time series
+  EventId m_sampleEvent;            // event ending the current sampling window
+  std::vector<Ptr<PacketSink> > m_staSinks;  // packet sink of each station (station index)
+  std::vector<uint64_t> m_sampleRx;          // bytes received by each station until the last sample
+  std::vector<uint64_t> m_sampleFailed;      // TX failures of each station in the current window
+  std::vector<uint64_t> m_sampleExpired;     // expired MSDUs of each station in the current window
+  uint64_t m_sampleTxops;           // TXOPs ended in the current window
+  Time m_sampleTxopTime;            // duration of the TXOPs ended in the current window
+  Ptr<ApWifiMac> m_apMac;           // MAC of the AP (set when traffic starts)
+  Ptr<QosTxop> m_apBeTxop;          // BE Txop of the AP (set when traffic starts)
+  Ptr<WifiMacQueue> m_apBeQueue;    // BE EDCA queue of the AP (set when traffic starts)
+  Mac48Address m_apAddress;         // MAC address of the AP (set when traffic starts)
+  Time m_apMaxDelay;                // max delay of the BE EDCA queue of the AP (set when traffic starts)
+  Ipv4InterfaceContainer ApInterface;  //Interface for ap // jaishreeram
+  /// Categories of channel time during the measurement period
+  enum AirtimeCategory
+  {
+    AIRTIME_PAYLOAD = 0,   // data symbols carrying QoS data frames
+    AIRTIME_PHY_OVERHEAD,  // preamble, padding and unassigned RUs of data PPDUs
+    AIRTIME_TRIGGER,       // Trigger Frames other than MU-BAR
+    AIRTIME_MU_BAR,        // MU-BAR Trigger Frames
+    AIRTIME_BLOCK_ACK,     // BlockAck, BlockAckReq and Ack frames
+    AIRTIME_OTHER,         // management and other control frames
+    AIRTIME_IDLE,          // contention, interframe spaces and idle channel
+    AIRTIME_N_CATEGORIES
+  };
+  std::vector<double> m_airtime;     // channel time of each category (seconds)
+  std::vector<double> m_staAirtime;  // airtime charged to each station (seconds)
+  std::unordered_map<uint64_t /* MAC address */, std::size_t /* station index */> m_staIndexByAddress;
+  std::vector<std::size_t> m_staIndexByAid;  // built as stations associate
+  std::string m_traceFile;          // binary trace of the measurement period (empty to disable)
+  BinaryTraceWriter m_trace;        // writer of the binary trace
+  uint32_t m_nTracedPpdus;          // number of PPDUs traced so far
+  std::string m_readTrace;          // binary trace to recompute the statistics from
+};
+
+/**
+ * Forward the packets received by the packet sink of a station to the example.
+ *
+ * \param example the example
+ * \param staId the index of the station
+ * \param p the received packet
+ * \param from the address of the sender
+ */
+static void
+SinkRxTrace (WifiDlOfdmaExample *example, std::size_t staId, Ptr<const Packet> p, const Address &from)
+{
+  example->NotifySinkRx (staId, p);
+}
+
+/**
+ * Forward the packets forwarded up by the MAC of a station to the example.
+ *
+ * \param example the example
+ * \param staId the index of the station
+ * \param p the received packet
+ */
+static void
+MacRxTrace (WifiDlOfdmaExample *example, std::size_t staId, Ptr<const Packet> p)
+{
+  example->NotifyApplicationRx (staId, p);
+}
+
+/**
+ * Forward the association of a station to the example.
+ *
+ * \param example the example
+ * \param staId the index of the station
+ * \param bssid the BSSID of the AP the station associated with
+ */
+static void
+AssocTrace (WifiDlOfdmaExample *example, std::size_t staId, Mac48Address bssid)
+{
+  example->EstablishBaAgreement (staId, bssid);
+}
+
+WifiDlOfdmaExample::WifiDlOfdmaExample ()
+  : m_payloadSize (160),    //jaishreeram changed it to 160 to simulate voice calls
+    m_simulationTime (2),
+    m_nStations (10),   // by default it was 4 jaishreeram
+    m_radius (10),
+    m_enableDlOfdma (true),
+    m_forceDlOfdma (true),
+    m_enableUlOfdma (false),
+    m_ulPsduSize (0),
+    m_channelWidth (20),
+    m_channelNumber (36),
+    m_channelCenterFrequency (0),
+    m_guardInterval (3200),
+    m_maxNRus (4),
+    m_ofdmaManager ("Rr"),
+    m_delayBudget (20),
+    m_mcs (0),
+    m_maxAmsduSize (7500),
+    m_maxAmpduSize (8388607u),
+    m_txopLimit (5440),
+    m_macQueueSize (0),  // invalid value
+    m_msduLifetime (0),  // invalid value
+    m_enableRts (false),
+    m_dataRate (0),      // invalid value //jaishreeram made it 10kbps for simulating voice calls
+    m_dlAckSeqType (1),
+    m_continueTxop (false),
+    m_baBufferSize (64),
+    m_transport ("Udp"),
+    m_queueDisc ("default"),
+    m_cacheLinkGains (true),
+    m_cacheTxDurations (true),
+    m_flowMonitor ("Xml"),
+    m_flowMonitorFile ("wifi-dl-ofdma-flows.xml"),
+    m_flowMonitorHistograms (true),
+    m_flowMonitorProbes (true),
+    m_enablePcap (false),
+    m_warmup (1.0),
+    m_maxWarmup (0.0),
+    m_adaptiveWarmup (false),
+    m_warmupSampleInterval (10),
+    m_warmupRx (0),
+    m_warmupDuration (0.0),
+    m_mserTruncation (-1.0),
+    m_currentSta (0),
+    m_assocBatchSize (1),
+    m_nAssocPending (0),
+    m_staticArp (false),
+    m_setupDuration (Seconds (0)),
+    m_setupWallTime (0.0),
+    m_ssid (Ssid ("network-A")),
+    m_port (50000), //jaishreeram changed from 7000 to 50000
+    m_port_bulk(50001), //jaishreeram port for bulksend
+    m_multiFlowSource (false),
+    m_trafficTrace (""),
+    m_traceTimeScale (1.0),
+    m_traceLoop (true),
+    m_maxTxop (Seconds (0)),
+    m_nextWriteId (0),
+    m_latencyMode ("App"),
+    m_verbose (false),
+    m_os (&std::cout),
+    m_sweepJobs (0),
+    m_sweepOutput ("sweep-results"),
+    m_benchmarkFullGrid (false),
+    m_benchmarkThreshold (0.1),
+    m_benchmarkEventsThreshold (0.1),
+    m_benchmarkRssThreshold (0.1),
+    m_benchmarkThroughputThreshold (0.001),
+    m_benchmarkUpdate (false),
+    m_benchmarkJobs (1),
+    m_benchmarkOutput ("benchmark-results"),
+    m_replications (0),
+    m_minReplications (3),
+    m_replicationPrecision (0),
+    m_replicationJobs (0),
+    m_replicationOutput ("replication-results"),
+    m_scenarioOutput ("scenario-results.csv"),
+    m_variantJobs (0),
+    m_variantOutput ("variant-results"),
+    m_variantIndex (VARIANT_NONE),
+    m_targetPrecision (0),
+    m_batchDuration (100),
+    m_minBatches (10),
+    m_converged (false),
+    m_batchRx (0),
+    m_batchLatencySum (0.0),
+    m_batchLatencyCount (0),
+    m_sampleInterval (0),
+    m_timeSeriesFile ("wifi-dl-ofdma-ts.csv"),
+    m_sampleTxops (0),
+    m_sampleTxopTime (Seconds (0)),
+    m_nTracedPpdus (0)
+{
+}
+
+void
+WifiDlOfdmaExample::SetOutputStream (std::ostream& os)
+{
+  m_os = &os;
+}
+
+void
+WifiDlOfdmaExample::Config (int argc, char *argv[])
+{
+  NS_LOG_FUNCTION (this);
+
+  CommandLine cmd;
+  cmd.AddValue ("payloadSize", "Payload size in bytes", m_payloadSize);
+  cmd.AddValue ("simulationTime", "Simulation time in seconds", m_simulationTime);
+  cmd.AddValue ("nStations", "Number of non-AP stations", m_nStations);
+  cmd.AddValue ("radius", "Radius of the disc centered in the AP and containing all the non-AP STAs", m_radius);
+  cmd.AddValue ("enableDlOfdma", "Enable/disable DL OFDMA", m_enableDlOfdma);
+  cmd.AddValue ("forceDlOfdma", "The RR scheduler always returns DL OFDMA", m_forceDlOfdma);
+  cmd.AddValue ("dlAckType", "Ack sequence type for DL OFDMA (1-3)", m_dlAckSeqType);
+  cmd.AddValue ("enableUlOfdma", "The RR scheduler returns UL OFDMA after DL OFDMA", m_enableUlOfdma);
+  cmd.AddValue ("ulPsduSize", "Max size in bytes of HE TB PPDUs", m_ulPsduSize);
+  cmd.AddValue ("channelWidth", "Channel bandwidth (20, 40, 80, 160)", m_channelWidth);
+  cmd.AddValue ("guardInterval", "Guard Interval (800, 1600, 3200)", m_guardInterval);
+  cmd.AddValue ("maxRus", "Maximum number of RUs allocated per DL MU PPDU", m_maxNRus);
+  cmd.AddValue ("ofdmaManager", "OFDMA manager of the AP (Rr, DelayAware)", m_ofdmaManager);
+  cmd.AddValue ("delayBudget", "Delay budget (ms) of latency-sensitive stations (DelayAware manager)", m_delayBudget);
+  cmd.AddValue ("mcs", "The constant MCS value to transmit HE PPDUs", m_mcs);
+  cmd.AddValue ("maxAmsduSize", "Maximum A-MSDU size", m_maxAmsduSize);
+  cmd.AddValue ("maxAmpduSize", "Maximum A-MPDU size", m_maxAmpduSize);
+  cmd.AddValue ("txopLimit", "TXOP duration in microseconds", m_txopLimit);
+  cmd.AddValue ("queueSize", "Maximum size of a WifiMacQueue (packets)", m_macQueueSize);
+  cmd.AddValue ("msduLifetime", "Maximum MSDU lifetime in milliseconds", m_msduLifetime);
+  cmd.AddValue ("continueTxop", "Continue TXOP if no SU response after MU PPDU", m_continueTxop);
+  cmd.AddValue ("baBufferSize", "Block Ack buffer size", m_baBufferSize);
+//   cmd.AddValue ("enableRts", "Enable or disable RTS/CTS", m_enableRts);
+  cmd.AddValue ("dataRate", "Per-station data rate (Mb/s)", m_dataRate);
+  cmd.AddValue ("transport", "Transport layer protocol (Udp/Tcp)", m_transport);
+  cmd.AddValue ("queueDisc", "Queuing discipline to install on the AP (default/none)", m_queueDisc);
+  cmd.AddValue ("cacheLinkGains", "Precompute the gains and delays of all the links (nodes do not move)", m_cacheLinkGains);
+  cmd.AddValue ("multiFlowSource", "Generate the traffic of all the stations with a single application on the AP", m_multiFlowSource);
+  cmd.AddValue ("trafficTrace", "Packet trace (binary or CSV) to replay instead of running client applications", m_trafficTrace);
+  cmd.AddValue ("traceTimeScale", "Factor multiplying the inter-packet times of the packet trace", m_traceTimeScale);
+  cmd.AddValue ("traceLoop", "Replay the packet trace again once finished", m_traceLoop);
+  cmd.AddValue ("cacheTxDurations", "Look up the durations of PPDUs and Trigger Frame UL Lengths in a cache", m_cacheTxDurations);
+  cmd.AddValue ("flowMonitor", "Format of the flow monitor statistics (Xml, Csv or None to disable the flow monitor)", m_flowMonitor);
+  cmd.AddValue ("flowMonitorFile", "File storing the flow monitor statistics (sweep, benchmark and replication "
+                "workers and variants prefix it with the name of their point)", m_flowMonitorFile);
+  cmd.AddValue ("flowMonitorHistograms", "Include histograms in the flow monitor statistics (output only: "
+                "histograms are always maintained while the flow monitor runs)", m_flowMonitorHistograms);
+  cmd.AddValue ("flowMonitorProbes", "Include per-probe flow monitor statistics (output only: probes are "
+                "always active while the flow monitor runs; use flowMonitor=None to avoid their cost)", m_flowMonitorProbes);
+  cmd.AddValue ("traceFile", "Binary trace of the PPDUs and MSDU events of the measurement period (empty = disabled)", m_traceFile);
+  cmd.AddValue ("readTrace", "Recompute the statistics from the given binary trace instead of simulating", m_readTrace);
+  cmd.AddValue ("warmup", "Duration of the warmup period (minimum duration if adaptiveWarmup is set) in seconds", m_warmup);
+  cmd.AddValue ("maxWarmup", "Maximum duration of the adaptive warmup period in seconds (0 to use simulationTime)", m_maxWarmup);
+  cmd.AddValue ("adaptiveWarmup", "End the warmup period when the MSER-5 rule detects the end of the transient "
+                "of throughput and AP queue occupancy", m_adaptiveWarmup);
+  cmd.AddValue ("warmupSampleInterval", "Interval between throughput and queue occupancy samples "
+                "of the adaptive warmup period in ms", m_warmupSampleInterval);
+  cmd.AddValue ("assocBatchSize", "Number of stations associating with the AP at the same time", m_assocBatchSize);
+  cmd.AddValue ("staticArp", "Populate the ARP caches instead of resolving addresses", m_staticArp);
+  cmd.AddValue ("enablePcap", "Enable PCAP trace file generation.", m_enablePcap);
+  cmd.AddValue ("latencyMode", "Measure latency between applications (App) or MAC layers (Mac)", m_latencyMode);
+  cmd.AddValue ("resultsJson", "JSON Lines file the results of the run are appended to", m_resultsJson);
+  cmd.AddValue ("resultsCsv", "CSV file the results of the run are appended to", m_resultsCsv);
+  cmd.AddValue ("targetPrecision", "End the measurement period when the relative half-width of the 95% CI "
+                "of throughput and latency falls below this value (0 = fixed simulationTime)", m_targetPrecision);
+  cmd.AddValue ("batchDuration", "Duration of the batches of the measurement period in ms", m_batchDuration);
+  cmd.AddValue ("minBatches", "Minimum number of batches before checking convergence", m_minBatches);
+  cmd.AddValue ("sampleInterval", "Interval between samples of the time series in ms (0 = disabled)", m_sampleInterval);
+  cmd.AddValue ("timeSeriesFile", "File storing the time series of the per-station statistics", m_timeSeriesFile);
+  cmd.AddValue ("verbose", "Enable/disable all Wi-Fi debug traces", m_verbose);
+  cmd.AddValue ("sweep", "File listing the parameter grids to sweep (one grid per line)", m_sweepFile);
+  cmd.AddValue ("sweepJobs", "Maximum number of concurrent sweep workers (0 = one per core)", m_sweepJobs);
+  cmd.AddValue ("sweepOutput", "Directory storing the results table and the logs of the sweep", m_sweepOutput);
+  cmd.AddValue ("benchmark", "Run the benchmark and compare it against the baseline stored in this file", m_benchmark);
+  cmd.AddValue ("benchmarkGrid", "File listing the parameter grids of the benchmark (built-in grid if empty)", m_benchmarkGrid);
+  cmd.AddValue ("benchmarkFullGrid", "Run the full built-in benchmark grid (up to 1000 stations) rather than the default one", m_benchmarkFullGrid);
+  cmd.AddValue ("benchmarkThreshold", "Maximum relative slowdown with respect to the baseline", m_benchmarkThreshold);
+  cmd.AddValue ("benchmarkEventsThreshold", "Maximum relative drop of the events per second with respect to the baseline", m_benchmarkEventsThreshold);
+  cmd.AddValue ("benchmarkRssThreshold", "Maximum relative growth of the peak memory with respect to the baseline", m_benchmarkRssThreshold);
+  cmd.AddValue ("benchmarkThroughputThreshold", "Relative change of the throughput with respect to the baseline above which a point is flagged", m_benchmarkThroughputThreshold);
+  cmd.AddValue ("benchmarkUpdate", "Store the benchmark results as the new baseline", m_benchmarkUpdate);
+  cmd.AddValue ("benchmarkJobs", "Number of concurrent benchmark workers", m_benchmarkJobs);
+  cmd.AddValue ("benchmarkOutput", "Directory storing the results and the logs of the benchmark", m_benchmarkOutput);
+  cmd.AddValue ("replications", "Maximum number of independent replications (distinct RngRun) to run", m_replications);
+  cmd.AddValue ("minReplications", "Minimum number of replications before checking the precision", m_minReplications);
+  cmd.AddValue ("replicationPrecision", "Stop starting replications when the relative half-width of the 95% CI "
+                "of throughput and latency falls below this value (0 = run all of them)", m_replicationPrecision);
+  cmd.AddValue ("replicationJobs", "Maximum number of concurrent replications (0 = one per core)", m_replicationJobs);
+  cmd.AddValue ("replicationOutput", "Directory storing the results table and the logs of the replications", m_replicationOutput);
+  cmd.AddValue ("variants", "Measurement period variants sharing association and warmup "
+                "(e.g., dataRate=10,txopLimit=2000;dataRate=20)", m_variantSpec);
+  cmd.AddValue ("variantJobs", "Maximum number of concurrent variants (0 = one per core)", m_variantJobs);
+  cmd.AddValue ("variantOutput", "Directory storing the results table and the logs of the variants", m_variantOutput);
+  cmd.AddValue ("scenarios", "File listing the scenarios to run one after another in this process "
+                "(one scenario per line)", m_scenarios);
+  cmd.AddValue ("scenarioOutput", "CSV file the summaries of the scenarios are appended to", m_scenarioOutput);
+  cmd.Parse (argc, argv);
+
+  if (!m_sweepFile.empty () || m_replications > 0 || !m_benchmark.empty () || !m_readTrace.empty ()
+      || !m_scenarios.empty ())
+    {
+      // the configuration of each point (replication) is parsed by the corresponding worker
+      return;
+    }
+
+  // the simulator is not touched before the command line is parsed, so that
+  // the simulator and scheduler types can be set from the command line
+  m_profiler.StartPhase ("Config");
+
+  uint64_t phyRate = WifiPhy::GetHeMcs (m_mcs).GetDataRate (m_channelWidth, m_guardInterval, 1);
+  // Estimate the A-MPDU size as the number of bytes transmitted at the PHY rate in
+  // an interval equal to the maximum PPDU duration
+  uint32_t ampduSize = phyRate * GetPpduMaxTime (WIFI_PREAMBLE_HE_SU).GetSeconds () / 8;  // bytes
+  // Estimate the number of MSDUs per A-MPDU as the ratio of the A-MPDU size to the MSDU size
+  uint32_t nMsdus = ampduSize / m_payloadSize;
+  // AP's EDCA queue must contain the number of MSDUs per A-MPDU times the number of stations,
+  // times a surplus coefficient
+  uint32_t queueSize = nMsdus * m_nStations * 2 /* surplus */;
+  // The MSDU lifetime must exceed the time taken by the AP to empty its EDCA queue at the PHY rate
+  uint32_t msduLifetime = queueSize * m_payloadSize * 8 * 1000. / phyRate * 2 /* surplus */;
+
+  if (m_macQueueSize == 0)
+    {
+      m_macQueueSize = queueSize;
+    }
+  if (m_msduLifetime == 0)
+    {
+      m_msduLifetime = msduLifetime;
+    }
+  if (m_dataRate == 0)
+    {
+      m_dataRate = phyRate * 1.2 /* surplus */ / 1e6 / m_nStations;
+      m_dataRate*=2;
+    }
+  if (m_latencyMode != "App" && m_latencyMode != "Mac")
+    {
+      NS_FATAL_ERROR ("Invalid latency mode (must be App or Mac)");
+    }
+  if (m_flowMonitor != "Xml" && m_flowMonitor != "Csv" && m_flowMonitor != "None")
+    {
+      NS_FATAL_ERROR ("Invalid flow monitor format (must be Xml, Csv or None)");
+    }
+  if (m_assocBatchSize == 0)
+    {
+      NS_FATAL_ERROR ("Invalid association batch size (must be at least 1)");
+    }
+
+  // Variants are separated by semicolons, the settings of a variant by commas
+  std::set<std::string> variantSettings {"dataRate", "payloadSize", "txopLimit", "msduLifetime",
+                                         "maxAmsduSize", "maxAmpduSize", "forceDlOfdma", "simulationTime"};
+  std::istringstream variantSpec (m_variantSpec);
+  std::string variant;
+  while (std::getline (variantSpec, variant, ';'))
+    {
+      std::istringstream settingList (variant);
+      std::string setting;
+      std::vector<std::pair<std::string, std::string> > settings;
+      while (std::getline (settingList, setting, ','))
+        {
+          std::size_t pos = setting.find ('=');
+          if (pos == std::string::npos || variantSettings.find (setting.substr (0, pos)) == variantSettings.end ())
+            {
+              NS_FATAL_ERROR ("Invalid variant setting: " << setting);
+            }
+          settings.push_back (std::make_pair (setting.substr (0, pos), setting.substr (pos + 1)));
+        }
+      if (!settings.empty ())
+        {
+          m_variants.push_back (variant);
+          m_variantList.push_back (settings);
+        }
+    }
+
+  switch (m_channelWidth)
+    {
+    case 20:
+      m_channelNumber = 36;
+      break;
+    case 40:
+      m_channelNumber = 38;
+      break;
+    case 80:
+      m_channelNumber = 42;
+      break;
+    case 160:
+      m_channelNumber = 50;
+      break;
+    default:
+      NS_FATAL_ERROR ("Invalid channel bandwidth (must be 20, 40, 80 or 160)");
+    }
+
+  *m_os << "Channel bw = " << m_channelWidth << " MHz" << std::endl
+        << "MCS = " << m_mcs << std::endl
+        << "Number of stations = " << m_nStations << std::endl
+        << "Data rate = " << m_dataRate << " Mbps" << std::endl
+        << "EDCA queue max size = " << m_macQueueSize << " MSDUs" << std::endl
+        << "MSDU lifetime = " << m_msduLifetime << " ms" << std::endl
+        << "BA buffer size = " << m_baBufferSize << std::endl;
+  if (m_enableDlOfdma)
+    {
+      *m_os << "Ack sequence = " << m_dlAckSeqType << std::endl;
+    }
+  else
+    {
+      *m_os << "No OFDMA" << std::endl;
+    }
+  *m_os << std::endl;
+}
+
+void
+WifiDlOfdmaExample::Setup (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_profiler.StartPhase ("Setup");
+
+  Config::SetDefault ("ns3::WifiRemoteStationManager::RtsCtsThreshold", m_enableRts ? StringValue ("0") : StringValue ("999999"));
+  Config::SetDefault ("ns3::HeConfiguration::GuardInterval", TimeValue (NanoSeconds (m_guardInterval)));
+  Config::SetDefault ("ns3::WifiPhy::GuardInterval", TimeValue (NanoSeconds (m_guardInterval)));
+  Config::SetDefault ("ns3::RegularWifiMac::ContinueTxopIfNoSuResponseAfterMuPpdu", BooleanValue (m_continueTxop));
+  Config::SetDefault ("ns3::ArpCache::AliveTimeout", TimeValue (Seconds (3600 * 24))); // ARP cache entries expire after one day
+  Config::SetDefault ("ns3::WifiMacQueue::MaxQueueSize", QueueSizeValue (QueueSize (PACKETS, m_macQueueSize)));
+  Config::SetDefault ("ns3::WifiMacQueue::MaxDelay", TimeValue (MilliSeconds (m_msduLifetime)));
+  Config::SetDefault ("ns3::HeConfiguration::MpduBufferSize", UintegerValue (m_baBufferSize));
+
+  m_staNodes.Create (m_nStations);
+  m_apNodes.Create (1);
+
+  Ptr<MultiModelSpectrumChannel> spectrumChannel = CreateObject<MultiModelSpectrumChannel> ();
+  Ptr<FriisPropagationLossModel> lossModel = CreateObject<FriisPropagationLossModel> ();
+  Ptr<ConstantSpeedPropagationDelayModel> delayModel = CreateObject<ConstantSpeedPropagationDelayModel> ();
+  Ptr<CachedPropagationLossModel> cachedLossModel;
+  Ptr<CachedPropagationDelayModel> cachedDelayModel;
+  if (m_cacheLinkGains)
+    {
+      // Nodes do not move, hence link gains and delays are computed once (after
+      // the nodes are placed) and then looked up for every transmission
+      cachedLossModel = CreateObject<CachedPropagationLossModel> ();
+      cachedLossModel->SetUnderlyingModel (lossModel);
+      spectrumChannel->AddPropagationLossModel (cachedLossModel);
+      cachedDelayModel = CreateObject<CachedPropagationDelayModel> ();
+      cachedDelayModel->SetUnderlyingModel (delayModel);
+      spectrumChannel->SetPropagationDelayModel (cachedDelayModel);
+    }
+  else
+    {
+      spectrumChannel->AddPropagationLossModel (lossModel);
+      spectrumChannel->SetPropagationDelayModel (delayModel);
+    }
+  SpectrumWifiPhyHelper phy = SpectrumWifiPhyHelper::Default ();
+  phy.SetPcapDataLinkType (WifiPhyHelper::DLT_IEEE802_11_RADIO);
+  phy.SetChannel (spectrumChannel);
+  phy.Set ("ChannelNumber", UintegerValue (m_channelNumber));
+  phy.Set ("ChannelWidth", UintegerValue (m_channelWidth));
+
+  WifiHelper wifi;
+  if (m_verbose)
+    {
+      wifi.EnableLogComponents ();
+    }
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ax_5GHZ);
+  std::ostringstream oss;
+  oss << "HeMcs" << m_mcs;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue (oss.str ()),
+                                "ControlMode", StringValue (oss.str ()));
+  switch (m_dlAckSeqType)
+    {
+    case 1:
+      wifi.SetAckPolicySelectorForAc (AC_BE, "ns3::ConstantWifiAckPolicySelector",
+                                      "DlAckSequenceType", UintegerValue (DlMuAckSequenceType::DL_SU_FORMAT));
+      break;
+    case 2:
+      wifi.SetAckPolicySelectorForAc (AC_BE, "ns3::ConstantWifiAckPolicySelector",
+                                      "DlAckSequenceType", UintegerValue (DlMuAckSequenceType::DL_MU_BAR));
+      break;
+    case 3:
+      wifi.SetAckPolicySelectorForAc (AC_BE, "ns3::ConstantWifiAckPolicySelector",
+                                      "DlAckSequenceType", UintegerValue (DlMuAckSequenceType::DL_AGGREGATE_TF));
+      break;
+    default:
+      NS_FATAL_ERROR ("Invalid DL ack sequence type (must be 1, 2 or 3)");
+    }
+
+  WifiMacHelper mac;
+  if (m_enableDlOfdma)
+    {
+      if (m_ofdmaManager == "DelayAware")
+        {
+          NS_ABORT_MSG_IF (m_enableUlOfdma, "The DelayAware OFDMA manager does not support UL OFDMA");
+          mac.SetOfdmaManager ("ns3::DelayAwareOfdmaManager",
+                               "NStations", UintegerValue (m_maxNRus),
+                               "ForceDlOfdma", BooleanValue (m_forceDlOfdma),
+                               "DelayBudget", TimeValue (MicroSeconds (m_delayBudget * 1000)));
+        }
+      else
+        {
+          NS_ABORT_MSG_IF (m_ofdmaManager != "Rr", "Invalid OFDMA manager (must be Rr or DelayAware)");
+          mac.SetOfdmaManager ("ns3::RrOfdmaManager",
+                               "NStations", UintegerValue (m_maxNRus),
+                               "ForceDlOfdma", BooleanValue (m_forceDlOfdma),
+                               "EnableUlOfdma", BooleanValue (m_enableUlOfdma),
+                               "UlPsduSize", UintegerValue (m_ulPsduSize));
+        }
+    }
+
+  mac.SetType ("ns3::StaWifiMac",
+              "Ssid", SsidValue (Ssid ("non-existing-ssid")));  // prevent stations from automatically associating
+  m_staDevices = wifi.Install (phy, mac, m_staNodes);
+
+  mac.SetType ("ns3::ApWifiMac",
+               "Ssid", SsidValue (m_ssid));
+  m_apDevices = wifi.Install (phy, mac, m_apNodes);
+
+  // Configure max A-MSDU size and max A-MPDU size on the AP
+  Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice> (m_apDevices.Get (0));
+  dev->GetMac ()->SetAttribute ("BE_MaxAmsduSize", UintegerValue (m_maxAmsduSize));
+  dev->GetMac ()->SetAttribute ("BE_MaxAmpduSize", UintegerValue (m_maxAmpduSize));
+  m_channelCenterFrequency = dev->GetPhy ()->GetFrequency ();
+  m_txDurationCache.SetFrequency (m_channelCenterFrequency);
+  m_txDurationCache.SetEnabled (m_cacheTxDurations);
+  // Configure TXOP Limit on the AP
+  PointerValue ptr;
+  dev->GetMac ()->GetAttribute ("BE_Txop", ptr);
+  ptr.Get<QosTxop> ()->SetTxopLimit (MicroSeconds (m_txopLimit));
+
+  // Configure max A-MSDU size and max A-MPDU size on the stations
+  m_stats.Reset (m_nStations);
+  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+    {
+      dev = DynamicCast<WifiNetDevice> (m_staDevices.Get (i));
+      dev->GetMac ()->SetAttribute ("BE_MaxAmsduSize", UintegerValue (m_maxAmsduSize));
+      dev->GetMac ()->SetAttribute ("BE_MaxAmpduSize", UintegerValue (m_maxAmpduSize));
+      m_staIndexByAddress[AddressToInteger (dev->GetMac ()->GetAddress ())] = i;
+    }
+
+  if (m_enableDlOfdma && m_ofdmaManager == "DelayAware")
+    {
+      // the odd stations receive the voice-like OnOff flows
+      Ptr<DelayAwareOfdmaManager> ofdmaManager = DynamicCast<WifiNetDevice> (m_apDevices.Get (0))->GetMac ()
+                                                   ->GetObject<DelayAwareOfdmaManager> ();
+      NS_ASSERT (ofdmaManager != 0);
+      for (uint32_t i = 1; i < m_staNodes.GetN (); i += 2)
+        {
+          ofdmaManager->SetLatencySensitive (DynamicCast<WifiNetDevice> (m_staDevices.Get (i))->GetMac ()->GetAddress ());
+        }
+    }
+
+  // Setting mobility model
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));  // position of the AP
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (m_apNodes);
+
+  mobility.SetPositionAllocator ("ns3::UniformDiscPositionAllocator",
+                                 "rho", DoubleValue (m_radius));
+  mobility.Install (m_staNodes);
+
+  if (m_cacheLinkGains)
+    {
+      NodeContainer allNodes (m_apNodes, m_staNodes);
+      cachedLossModel->Precompute (allNodes);
+      cachedDelayModel->Precompute (allNodes);
+    }
+
+  /* Internet stack */
+  InternetStackHelper stack;
+  stack.Install (m_apNodes);
+  stack.Install (m_staNodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("192.168.1.0", "255.255.255.0");
+  // Ipv4InterfaceContainer ApInterface;    //commented it jaishreeram
+  ApInterface = address.Assign (m_apDevices);
+  m_staInterfaces = address.Assign (m_staDevices);
+
+  /* Traffic Control layer */
+  TrafficControlHelper tch;
+  if (m_queueDisc.compare ("default") != 0)
+    {
+      // Uninstall the root queue disc on the AP netdevice
+      tch.Uninstall (m_apDevices);
+    }
+
+  /* Transport and application layer */
+  std::string socketType = (m_transport.compare ("Tcp") == 0 ? "ns3::TcpSocketFactory" : "ns3::UdpSocketFactory");
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (2048)); //commented it jaishreeram
+
+  PacketSinkHelper packetSinkHelper (socketType, InetSocketAddress (Ipv4Address::GetAny (), m_port));
+  // m_sinkApps = packetSinkHelper.Install (m_staNodes);
+  PacketSinkHelper bulkPacketSinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), m_port_bulk));
+
+
+  //jaishreeram next few lines installs different applications for different nodes
+  for(uint32_t i=0;i<m_staNodes.GetN();i++){
+    if(i%2==0){  //if the station uses bulksend application - tcp
+      ApplicationContainer temp = bulkPacketSinkHelper.Install(m_staNodes.Get(i));
+      m_sinkApps_bulk.Add(temp); 
+    }
+    else{ //otherwise - udp version
+      ApplicationContainer temp = packetSinkHelper.Install(m_staNodes.Get(i));
+      m_sinkApps.Add(temp);
+    }
+  }
+
+  m_sinkApps.Stop (Seconds (GetMaxWarmup () + m_simulationTime + 100)); // let the server be active for a long time
+  m_sinkApps_bulk.Stop (Seconds (GetMaxWarmup () + m_simulationTime + 100)); // let the server be active for a long time jaishreeram
+  
+
+  m_rxStart.assign (m_nStations, 0.0);
+  m_rxStop.assign (m_nStations, 0.0);
+
+  for (uint16_t i = 0; i < m_nStations; i++)
+    {
+      m_appLatencyMap.insert (std::make_pair (i, LatencyHistogram ()));
+    }
+
+  m_staClientApps.assign (m_nStations, 0);
+  m_sourceTxPackets.assign (m_nStations, 0);
+  m_sourceTxBytes.assign (m_nStations, 0);
+
+  NS_ABORT_MSG_IF (m_multiFlowSource && !m_trafficTrace.empty (),
+                   "The multi-flow source cannot be used when replaying a packet trace");
+  if (m_multiFlowSource)
+    {
+      // flows are added to the source as stations associate
+      m_source = CreateObject<MultiFlowSource> ();
+      m_apNodes.Get (0)->AddApplication (m_source);
+      // Stamp the send time on the packets sent by the source
+      m_source->TraceConnectWithoutContext ("Tx", MakeCallback (&WifiDlOfdmaExample::StampApplicationTx, this));
+      m_source->SetStartTime (Seconds (0));
+      m_staFlows.assign (m_nStations, 0);
+    }
+
+  for (uint32_t i = 0; i < m_staDevices.GetN (); i++)
+    {
+      DynamicCast<WifiNetDevice> (m_staDevices.Get (i))->GetMac ()
+        ->TraceConnectWithoutContext ("Assoc", MakeBoundCallback (&AssocTrace, this, static_cast<std::size_t> (i)));
+    }
+
+  if (m_staticArp)
+    {
+      PopulateArpCaches ();
+    }
+
+  if (m_enablePcap)
+    {
+      phy.EnablePcap ("STA_pcap_30STA_50SEC", m_staDevices);
+      phy.EnablePcap ("AP_pcap_30STA_50SEC", m_apDevices);
+    }
+}
+
+void
+WifiDlOfdmaExample::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  *m_os<<"---Entering Run()---\n";
+  m_runStartWallTime = std::chrono::steady_clock::now ();
+  m_profiler.StartPhase ("Association");
+  // Start the setup phase by having the first station associate with the AP
+  Simulator::ScheduleNow (&WifiDlOfdmaExample::StartAssociation, this);
+
+  //Added for flow monitor
+  Ptr<FlowMonitor> flowMonitor;
   FlowMonitorHelper flowHelper;
-  flowMonitor = flowHelper.InstallAll();
+  if (m_flowMonitor != "None")
+    {
+      flowMonitor = flowHelper.InstallAll ();
+    }
+
+  Simulator::Stop (Seconds (GetMaxWarmup () + m_simulationTime + 100));
+
+  //Using NetAnim 
+  // AnimationInterface anim("wifi-dl-ofdma.xml");
+  // uint32_t k=0;
+  // for(uint32_t i=0;i<6;i++){
+  //   for(uint32_t j=0;j<5;j++){
+  //   anim.SetConstantPosition(m_staNodes.Get(k++),i*2,j*2);
+  //   }
+  // }
+
+  //anim.SetConstantPosition(m_apNodes.Get(0),40.0,40.0);
+  
+  
+  Simulator::Run ();
+  m_profiler.StartPhase ("Reporting");
+
+  if (m_variantIndex == VARIANT_PARENT)
+    {
+      // results are reported by the child process of each variant
+      m_profiler.EndPhase ();
+      m_profiler.Print (*m_os);
+      Simulator::Destroy ();
+      *m_os<<"---Exiting Run()---\n";
+      return;
+    }
+
+  //Adding for flow monitor
+  if (flowMonitor != 0)
+    {
+      ExportFlowStats (flowMonitor, DynamicCast<Ipv4FlowClassifier> (flowHelper.GetClassifier ()));
+    }
+
+  double totalTput = 0.0;
+  double tput;
+  *m_os << "Throughput (Mbps)" << std::endl
+        << "-----------------" << std::endl;
+  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+    {
+      tput = ((m_rxStop[i] - m_rxStart[i]) * 8.) / (m_simulationTime * 1e6);
+      totalTput += tput;
+      *m_os << "STA_" << i << ": " << tput << " ";
+    }
+  *m_os << std::endl << std::endl << "Total throughput: " << totalTput << std::endl;
+
+  uint64_t totalFailed = 0;
+  uint64_t failed;
+  *m_os << std::endl << "TX failures" << std::endl
+                     << "-----------" << std::endl;
+  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+    {
+      failed = m_stats.GetDlStats (i).failed;
+      totalFailed += failed;
+      *m_os << "STA_" << i << ": " << failed << " ";
+    }
+  *m_os << std::endl << std::endl << "Total failed: " << totalFailed << std::endl;
+
+  uint64_t totalExpired = 0;
+  uint64_t expired;
+  *m_os << std::endl << "Expired MSDUs" << std::endl
+                     << "-------------" << std::endl;
+  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+    {
+      expired = m_stats.GetDlStats (i).expired;
+      totalExpired += expired;
+      *m_os << "STA_" << i << ": " << expired << " ";
+    }
+  *m_os << std::endl << std::endl << "Total expired: " << totalExpired << std::endl;
+
+  *m_os << std::endl << "(Min,Max,Count) A-MPDU size" << std::endl
+                     << "---------------------------" << std::endl;
+  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+    {
+      const WifiDlOfdmaStats::DlStats& stats = m_stats.GetDlStats (i);
+      *m_os << "STA_" << i << ": (" << stats.minAmpduSize << "," << stats.maxAmpduSize
+                           << "," << stats.nAmpdus << ") ";
+    }
+
+  *m_os << std::endl << std::endl << "Maximum TXOP duration: " << m_maxTxop.ToDouble (Time::MS) << "ms" << std::endl;
+
+  *m_os << std::endl << "(Min,Max,Avg) A-MPDU size to max A-MPDU size in DL MU PPDU ratio" << std::endl
+                     << "----------------------------------------------------------------" << std::endl;
+  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+    {
+      const WifiDlOfdmaStats::MinMaxAvg& ratio = m_stats.GetDlStats (i).ampduRatio;
+      *m_os << std::fixed << std::setprecision (3)
+            << "STA_" << i << ": (" << ratio.min << ", " << ratio.max
+                           << ", " << ratio.avg << ") ";
+    }
+
+  *m_os << std::endl << std::endl << "DL MU PPDU completeness: ("
+                                  << m_stats.GetDlMuPpduCompleteness ().min << ", "
+                                  << m_stats.GetDlMuPpduCompleteness ().max << ", "
+                                  << m_stats.GetDlMuPpduCompleteness ().avg << ")" << std::endl;
+
+  *m_os << std::endl << "(Min,Max,Avg) Pairwise head-of-line delay (ms)" << std::endl
+                     << "----------------------------------------------" << std::endl;
+  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+    {
+      const WifiDlOfdmaStats::MinMaxAvg& holDelay = m_stats.GetDlStats (i).holDelay;
+      *m_os << std::fixed << std::setprecision (3)
+            << "STA_" << i << ": (" << holDelay.min << ", " << holDelay.max
+                           << ", " << holDelay.avg << ") ";
+    }
+
+  *m_os << std::endl << std::endl << "Head-of-line delay (ms): ("
+                                  << m_stats.GetHolDelay ().min << ", "
+                                  << m_stats.GetHolDelay ().max << ", "
+                                  << m_stats.GetHolDelay ().avg << ")" << std::endl;
+
+  *m_os << std::endl << "Average latency (ms)" << std::endl
+                     << "--------------------" << std::endl;
+
+  LatencyHistogram overallLatency;
+  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+    {
+      auto it = m_appLatencyMap.find (i);
+      NS_ASSERT (it != m_appLatencyMap.end ());
+      double average_latency_ms = it->second.GetMean ().ToDouble (Time::MS);
+      *m_os << "STA_" << i << ": " << average_latency_ms << " ";
+      overallLatency.Merge (it->second);
+    }
+
+  *m_os << std::endl << std::endl << "(p50,p90,p99,p99.9,Max) Latency (ms)" << std::endl
+                     << "------------------------------------" << std::endl;
+  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+    {
+      auto it = m_appLatencyMap.find (i);
+      NS_ASSERT (it != m_appLatencyMap.end ());
+      *m_os << "STA_" << i << ": (" << it->second.GetPercentile (50).ToDouble (Time::MS)
+                           << ", " << it->second.GetPercentile (90).ToDouble (Time::MS)
+                           << ", " << it->second.GetPercentile (99).ToDouble (Time::MS)
+                           << ", " << it->second.GetPercentile (99.9).ToDouble (Time::MS)
+                           << ", " << it->second.GetMax ().ToDouble (Time::MS) << ") ";
+    }
+
+  *m_os << std::endl << std::endl << "Latency (ms): ("
+                                  << overallLatency.GetPercentile (50).ToDouble (Time::MS) << ", "
+                                  << overallLatency.GetPercentile (90).ToDouble (Time::MS) << ", "
+                                  << overallLatency.GetPercentile (99).ToDouble (Time::MS) << ", "
+                                  << overallLatency.GetPercentile (99.9).ToDouble (Time::MS) << ", "
+                                  << overallLatency.GetMax ().ToDouble (Time::MS) << ")" << std::endl;
+
+  *m_os << std::endl << std::endl << "Unresponded TFs ratio/(Min,Max,Avg) HE TB PPDU duration to UL Length ratio"
+                     << std::endl << "--------------------------------------------------------------------------"
+                     << std::endl;
+  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+    {
+      if(i%2==0)
+        continue;
+      const WifiDlOfdmaStats::UlStats& stats = m_stats.GetUlStats (i);
+      double unrespondedTfRatio = 0.0;
+      if (stats.nSolicitingTriggerFrames > 0)
+        {
+          unrespondedTfRatio = static_cast<double> (stats.nSolicitingTriggerFrames - stats.lengthRatio.count)
+                               / stats.nSolicitingTriggerFrames;
+        }
+
+      *m_os << std::fixed << std::setprecision (3)
+            << "STA_" << i << ": " << unrespondedTfRatio << "/(" << stats.lengthRatio.min
+                           << ", " << stats.lengthRatio.max
+                           << ", " << stats.lengthRatio.avg << ") ";
+    }
+
+  *m_os << std::endl << std::endl << "(Failed, Sent) Basic Trigger Frames: ("
+                                  << m_stats.GetNFailedTriggerFrames () << ", "
+                                  << m_stats.GetNBasicTriggerFramesSent () << ")" << std::endl;
+
+  uint64_t heTbPPduTotalCount = 0;
+  uint64_t solicitingTriggerFrames = 0;
+  for (std::size_t i = 0; i < m_stats.GetNStations (); i++)
+    {
+      heTbPPduTotalCount += m_stats.GetUlStats (i).lengthRatio.count;
+      solicitingTriggerFrames += m_stats.GetUlStats (i).nSolicitingTriggerFrames;
+    }
+  double missingHeTbPpduRatio = 0.0;
+  if (solicitingTriggerFrames > 0)
+    {
+      missingHeTbPpduRatio = static_cast<double> (solicitingTriggerFrames - heTbPPduTotalCount)
+                             / solicitingTriggerFrames;
+    }
+  *m_os << std::endl << "Missing HE TB PPDUs ratio: " << missingHeTbPpduRatio << std::endl;
+  *m_os << std::endl << "HE TB PPDU completeness: ("
+                     << m_stats.GetHeTbPpduCompleteness ().min << ", "
+                     << m_stats.GetHeTbPpduCompleteness ().max << ", "
+                     << m_stats.GetHeTbPpduCompleteness ().avg << ")" << std::endl << std::endl;
+
+  double busyTime = std::accumulate (m_airtime.begin (), m_airtime.end () - 1, 0.0);
+  m_airtime[AIRTIME_IDLE] = std::max (m_simulationTime - busyTime, 0.0);
+  *m_os << "Channel time (ms, % of the measurement period) with DL ack sequence " << m_dlAckSeqType << std::endl
+        << "---------------------------------------------------------------------" << std::endl;
+  for (std::size_t c = 0; c < AIRTIME_N_CATEGORIES; c++)
+    {
+      *m_os << std::fixed << std::setprecision (3) << GetAirtimeCategoryName (c) << ": ("
+            << m_airtime[c] * 1000 << ", " << m_airtime[c] / m_simulationTime * 100 << "%) ";
+    }
+
+  double totalStaAirtime = std::accumulate (m_staAirtime.begin (), m_staAirtime.end (), 0.0);
+  *m_os << std::endl << std::endl << "Airtime share" << std::endl
+                     << "-------------" << std::endl;
+  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+    {
+      *m_os << "STA_" << i << ": " << (totalStaAirtime > 0 ? m_staAirtime[i] / totalStaAirtime : 0.0) << " ";
+    }
+  *m_os << std::endl << std::endl << "Airtime fairness (Jain's index): " << GetAirtimeFairness ()
+        << std::endl << std::endl;
+
+  if (m_replay != 0)
+    {
+      *m_os << "Packet trace " << m_trafficTrace << ": " << m_replay->GetTxPackets () << " packets ("
+            << m_replay->GetTxBytes () << " bytes) sent, " << m_replay->GetNDropped () << " dropped, "
+            << m_replay->GetNSkipped () << " skipped, " << m_replay->GetNLoops () << " loops"
+            << std::endl << std::endl;
+    }
+
+  if (m_multiFlowSource)
+    {
+      *m_os << "Multi-flow source (packets, bytes sent)" << std::endl
+            << "--------------------------------------" << std::endl;
+      for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+        {
+          *m_os << "STA_" << i << ": (" << m_sourceTxPackets[i] << ", " << m_sourceTxBytes[i] << ") ";
+        }
+      *m_os << std::endl << std::endl;
+    }
+
+  // The reporting phase ends here, so that it is part of the summary and of the
+  // exported results. Collecting and serializing the results is measured as the
+  // output phase, which is only printed since it cannot export itself
+  m_profiler.EndPhase ();
+
+  // Summarize the results before the devices are disposed of
+  std::ostringstream summary;
+  summary << totalTput << "," << totalFailed << "," << totalExpired << ","
+          << m_maxTxop.ToDouble (Time::MS) << "," << m_stats.GetHolDelay ().avg << ","
+          << m_stats.GetDlMuPpduCompleteness ().avg << ","
+          << overallLatency.GetMean ().ToDouble (Time::MS) << ","
+          << overallLatency.GetPercentile (99).ToDouble (Time::MS) << ","
+          << m_setupDuration.GetSeconds () << "," << m_setupWallTime << ",";
+  // performance of the run, including reporting but excluding output
+  double runWallTime = 0.0;
+  uint64_t runEvents = 0;
+  uint64_t peakRssKb = 0;
+  for (auto& phase : m_profiler.GetPhases ())
+    {
+      runWallTime += phase.wallTime;
+      runEvents += phase.events;
+      peakRssKb = std::max (peakRssKb, phase.peakRssKb);
+    }
+  summary << runWallTime << "," << (runWallTime > 0 ? runEvents / runWallTime : 0.0) << "," << peakRssKb << ",";
+  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+    {
+      summary << (i > 0 ? ";" : "") << ((m_rxStop[i] - m_rxStart[i]) * 8.) / (m_simulationTime * 1e6);
+    }
+  m_summary = summary.str ();
+  if (m_variantIndex != VARIANT_NONE)
+    {
+      std::ofstream row (GetVariantFileName (m_variantIndex, ".row"));
+      row << m_summary << std::endl;
+    }
+
+  m_profiler.StartPhase ("Output");
+  CollectResults (overallLatency);
+  if (!m_resultsJson.empty ())
+    {
+      WriteJsonResults (m_resultsJson);
+    }
+  if (!m_resultsCsv.empty ())
+    {
+      WriteCsvResults (m_resultsCsv);
+    }
+
+  m_appPacketTxMap.clear ();
+  m_appLatencyMap.clear ();
+  m_partialWrites.clear ();
+
+  m_profiler.EndPhase ();
+  m_profiler.Print (*m_os);
+
+  Simulator::Destroy ();
+  *m_os<<"---Exiting Run()---\n";
+}
+
+/**
+ * \param os the output stream
+ * \param histogram a FlowMonitor histogram
+ *
+ * Write the non-empty bins of the given histogram as semicolon separated
+ * start:width:count triplets.
+ */
+static void
+WriteHistogram (std::ostream& os, Histogram histogram)
+{
+  bool first = true;
+  for (uint32_t bin = 0; bin < histogram.GetNBins (); bin++)
+    {
+      if (histogram.GetBinCount (bin) > 0)
+        {
+          os << (first ? "" : ";") << histogram.GetBinStart (bin) << ":" << histogram.GetBinWidth (bin)
+             << ":" << histogram.GetBinCount (bin);
+          first = false;
+        }
+    }
+}
+
+void
+WifiDlOfdmaExample::ExportFlowStats (Ptr<FlowMonitor> monitor, Ptr<Ipv4FlowClassifier> classifier) const
+{
+  NS_LOG_FUNCTION (this);
+
+  monitor->CheckForLostPackets ();
+
+  if (m_flowMonitor == "Xml")
+    {
+      monitor->SerializeToXmlFile (m_flowMonitorFile, m_flowMonitorHistograms, m_flowMonitorProbes);
+      return;
+    }
+
+  // Csv: every flow is written as soon as it is visited, no document is built in memory
+  std::ofstream flows (m_flowMonitorFile);
+  NS_ABORT_MSG_IF (!flows.is_open (), "Cannot open flow monitor file " << m_flowMonitorFile);
+  flows << std::setprecision (10)
+        << "flowId,srcAddr,srcPort,dstAddr,dstPort,protocol,timeFirstTxPacketS,timeFirstRxPacketS,"
+           "timeLastTxPacketS,timeLastRxPacketS,delaySumS,jitterSumS,lastDelayS,txBytes,rxBytes,"
+           "txPackets,rxPackets,lostPackets,timesForwarded,packetsDropped,bytesDropped";
+  if (m_flowMonitorHistograms)
+    {
+      flows << ",delayHistogram,jitterHistogram,packetSizeHistogram,flowInterruptionsHistogram";
+    }
+  flows << '\n';
+
+  const FlowMonitor::FlowStatsContainer& stats = monitor->GetFlowStats ();
+  for (FlowMonitor::FlowStatsContainerCI it = stats.begin (); it != stats.end (); it++)
+    {
+      const FlowMonitor::FlowStats& flow = it->second;
+      Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow (it->first);
+      uint64_t packetsDropped = std::accumulate (flow.packetsDropped.begin (), flow.packetsDropped.end (), 0ull);
+      uint64_t bytesDropped = std::accumulate (flow.bytesDropped.begin (), flow.bytesDropped.end (), 0ull);
+
+      flows << it->first << "," << t.sourceAddress << "," << t.sourcePort << ","
+            << t.destinationAddress << "," << t.destinationPort << "," << +t.protocol << ","
+            << flow.timeFirstTxPacket.GetSeconds () << "," << flow.timeFirstRxPacket.GetSeconds () << ","
+            << flow.timeLastTxPacket.GetSeconds () << "," << flow.timeLastRxPacket.GetSeconds () << ","
+            << flow.delaySum.GetSeconds () << "," << flow.jitterSum.GetSeconds () << ","
+            << flow.lastDelay.GetSeconds () << "," << flow.txBytes << "," << flow.rxBytes << ","
+            << flow.txPackets << "," << flow.rxPackets << "," << flow.lostPackets << ","
+            << flow.timesForwarded << "," << packetsDropped << "," << bytesDropped;
+      if (m_flowMonitorHistograms)
+        {
+          flows << ",";
+          WriteHistogram (flows, flow.delayHistogram);
+          flows << ",";
+          WriteHistogram (flows, flow.jitterHistogram);
+          flows << ",";
+          WriteHistogram (flows, flow.packetSizeHistogram);
+          flows << ",";
+          WriteHistogram (flows, flow.flowInterruptionsHistogram);
+        }
+      flows << '\n';
+    }
+  flows.close ();
+
+  if (m_flowMonitorProbes)
+    {
+      // per-probe statistics are written to a companion file
+      std::string probesFile = m_flowMonitorFile + ".probes.csv";
+      std::ofstream probes (probesFile);
+      NS_ABORT_MSG_IF (!probes.is_open (), "Cannot open flow monitor file " << probesFile);
+      probes << std::setprecision (10)
+             << "probeId,flowId,delayFromFirstProbeSumS,bytes,packets,packetsDropped,bytesDropped\n";
+
+      const FlowMonitor::FlowProbeContainer& allProbes = monitor->GetAllProbes ();
+      for (uint32_t probeId = 0; probeId < allProbes.size (); probeId++)
+        {
+          std::map<FlowId, FlowProbe::FlowStats> probeStats = allProbes[probeId]->GetStats ();
+          for (auto& flow : probeStats)
+            {
+              uint64_t packetsDropped = std::accumulate (flow.second.packetsDropped.begin (),
+                                                         flow.second.packetsDropped.end (), 0ull);
+              uint64_t bytesDropped = std::accumulate (flow.second.bytesDropped.begin (),
+                                                       flow.second.bytesDropped.end (), 0ull);
+              probes << probeId << "," << flow.first << ","
+                     << flow.second.delayFromFirstProbeSum.GetSeconds () << ","
+                     << flow.second.bytes << "," << flow.second.packets << ","
+                     << packetsDropped << "," << bytesDropped << '\n';
+            }
+        }
+    }
+}
+
+void
+WifiDlOfdmaExample::StartAssociation (void)
+{
+  *m_os<<"---\nEntering StartAssociation()---\n";
+  NS_LOG_FUNCTION (this << m_currentSta);
+  NS_ASSERT (m_currentSta < m_nStations);
+
+  // Stations of the same batch contend with each other to associate
+  std::size_t batchEnd = std::min<std::size_t> (m_currentSta + m_assocBatchSize, m_nStations);
+  m_nAssocPending = batchEnd - m_currentSta;
+
+  for (; m_currentSta < batchEnd; m_currentSta++)
+    {
+      Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice> (m_staDevices.Get (m_currentSta));
+      NS_ASSERT (dev != 0);
+      dev->GetMac ()->SetSsid (m_ssid); // this will lead the station to associate with the AP
+    }
+  *m_os<<"---Exiting StartAssociation()---\n";
+}
+
+void
+WifiDlOfdmaExample::EstablishBaAgreement (std::size_t staId, Mac48Address bssid)
+{
+  *m_os<<"\n------In EstablishBaAgreement------\n";
+  NS_LOG_FUNCTION (this << staId << bssid);
+
+  // Map the AID assigned to the station to its index
+  uint16_t aid = DynamicCast<StaWifiMac> (DynamicCast<WifiNetDevice> (m_staDevices.Get (staId))->GetMac ())
+                   ->GetAssociationId ();
+  if (aid >= m_staIndexByAid.size ())
+    {
+      m_staIndexByAid.resize (aid + 1, m_nStations);
+    }
+  m_staIndexByAid[aid] = staId;
+
+  // Now that the station is associated with the AP, let's trigger the creation
+  // of an entry in the ARP cache (of both the AP and the STA), unless the ARP caches
+  // have been populated already, and the establishment of a Block Ack agreement
+  // between the AP and the STA (and viceversa). This is done by having the AP send
+  // 3 ICMP Echo Requests to the STA
+  Time pingDuration = MilliSeconds (125);
+
+  V4PingHelper ping (m_staInterfaces.GetAddress (staId));
+  ping.SetAttribute ("Interval", TimeValue (MilliSeconds (50)));
+  if (m_verbose)
+    {
+      ping.SetAttribute ("Verbose", BooleanValue (true));
+    }
+  ApplicationContainer pingApps = ping.Install (m_apNodes);
+  pingApps.Stop (pingDuration);
+
+  // Install a client application on the current station. In case of TCP traffic,
+  // this will trigger the establishment of a TCP connection. The client application
+  // is initially quiet (i.e., it does not transmit packets -- this is achieved
+  // by setting the duration of the "On" interval to zero).
+  uint16_t offInterval = 10;  // milliseconds
+
+
+  if (!m_trafficTrace.empty ())
+    {
+      // the packet trace is replayed once all the stations are associated
+    }
+  else if(staId%2){    //if the clients dont use bulksend (use on off) jaishreeram
+    // std::stringstream ss;
+    // ss << "ns3::ConstantRandomVariable[Constant=" << std::fixed << static_cast<double> (offInterval / 1000.) << "]";
+
+    std::string socketType = (m_transport.compare ("Tcp") == 0 ? "ns3::TcpSocketFactory" : "ns3::UdpSocketFactory");
+    OnOffHelper client (socketType, Ipv4Address::GetAny ());
+    client.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
+    client.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
+    client.SetAttribute ("DataRate", DataRateValue (DataRate (m_dataRate * 1e6)));
+    client.SetAttribute ("PacketSize", UintegerValue (m_payloadSize));    //jaishreeram for on off changing it to 160bytes to sim voice calls
+
+    InetSocketAddress dest (m_staInterfaces.GetAddress (staId), m_port);
+    // dest.SetTos (0xb8); //AC_VI
+    client.SetAttribute ("Remote", AddressValue (dest));
+
+    // Make sure that the client application is started at a time that is an integer
+    // multiple of the offInterval. In fact, the client application will wake every
+    // offInterval milliseconds to check if a packet can be sent. Given that the duration
+    // of the "On" interval will be modified for all the client applications
+    // simultaneously, this ensures that all the client applications will actually
+    // start sending packets at the same time.
+    uint64_t startTime = std::ceil (Simulator::Now ().ToDouble (Time::MS) / offInterval) * offInterval;
+    *m_os<<"The Scheduled delay for this OnOff Client is "<<((static_cast<uint64_t> (startTime) + 110) - Simulator::Now ().ToDouble (Time::MS))<<"ms"<<"\n";
+    *m_os<<"Current time is "<<(Simulator::Now().ToDouble (Time::MS))<<"ms"<<"\n";
+    if (m_multiFlowSource)
+      {
+        Simulator::Schedule (MilliSeconds (static_cast<uint64_t> (startTime) + 110) - Simulator::Now (),
+                             &WifiDlOfdmaExample::AddSourceFlow, this, staId);
+      }
+    else
+      {
+        Simulator::Schedule (MilliSeconds (static_cast<uint64_t> (startTime) + 110) - Simulator::Now (),
+                            &WifiDlOfdmaExample::StartOnOffClient, this, staId, client);  //jaishreeram changed it to StartOnOffClient
+      }
+    *m_os<<"Current Station: "<<staId<<" (OnOff Client)"<<std::endl; 
+  }
+
+  else{     //if the clients use bulksend jaishreeram
+  //   std::stringstream ss;
+  // ss << "ns3::ConstantRandomVariable[Constant=" << std::fixed << static_cast<double> (offInterval / 1000.) << "]";
+
+  // std::string socketType = (m_transport.compare ("Tcp") == 0 ? "ns3::TcpSocketFactory" : "ns3::UdpSocketFactory");
+    BulkSendHelper client ("ns3::TcpSocketFactory", Ipv4Address::GetAny ());
+    client.SetAttribute ("SendSize", UintegerValue(2048));
+    client.SetAttribute ("MaxBytes", UintegerValue(10240000)); 
+    InetSocketAddress dest (m_staInterfaces.GetAddress (staId), m_port_bulk);
+    client.SetAttribute ("Remote", AddressValue (dest));
+
+    // InetSocketAddress dest (m_staInterfaces.GetAddress (m_currentSta), m_port);
+    // dest.SetTos (0xb8); //AC_VI
+    // client.SetAttribute ("Remote", AddressValue (dest));
+    *m_os<<"The Scheduled delay for this bulksend client is: "<<(47)<<"ms"<<"\n";
+    *m_os<<"Current time is "<<(Simulator::Now().ToDouble (Time::MS))<<"ms"<<"\n";
+    if (m_multiFlowSource)
+      {
+        Simulator::Schedule (MilliSeconds (47), &WifiDlOfdmaExample::AddSourceFlow, this, staId);
+      }
+    else
+      {
+        Simulator::Schedule (MilliSeconds (47), &WifiDlOfdmaExample::StartBulkSendClient, this, staId, client); //jaishreeram
+      }
+    *m_os<<"Current Station: "<<staId<<" (Bulksend Client)"<<std::endl;  
+  }
+  // continue with the next batch of stations, if any is remaining, once all the
+  // stations of the current batch are associated
+  NS_ASSERT (m_nAssocPending > 0);
+  if (--m_nAssocPending > 0)
+    {
+      return;
+    }
+    if (m_currentSta < m_nStations)
+      {
+        Simulator::Schedule (pingDuration, &WifiDlOfdmaExample::StartAssociation, this);
+      }
+    else
+      {
+        Simulator::Schedule (pingDuration, &WifiDlOfdmaExample::StartTraffic, this);
+      }
+      // exit(0);
+      // std::cout<<"ba agree end\n";
+}
+
+void
+WifiDlOfdmaExample::PopulateArpCaches (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Ptr<Ipv4L3Protocol> apIp = m_apNodes.Get (0)->GetObject<Ipv4L3Protocol> ();
+  Ptr<ArpCache> apCache = apIp->GetInterface (apIp->GetInterfaceForDevice (m_apDevices.Get (0)))->GetArpCache ();
+  ArpCache::Entry *entry;
+
+  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+    {
+      Ptr<Ipv4L3Protocol> staIp = m_staNodes.Get (i)->GetObject<Ipv4L3Protocol> ();
+      Ptr<ArpCache> staCache = staIp->GetInterface (staIp->GetInterfaceForDevice (m_staDevices.Get (i)))->GetArpCache ();
+
+      entry = apCache->Add (m_staInterfaces.GetAddress (i));
+      entry->SetMacAddress (m_staDevices.Get (i)->GetAddress ());
+      entry->MarkPermanent ();
+
+      entry = staCache->Add (ApInterface.GetAddress (0));
+      entry->SetMacAddress (m_apDevices.Get (0)->GetAddress ());
+      entry->MarkPermanent ();
+    }
+}
+
+void
+WifiDlOfdmaExample::StartBulkSendClient (std::size_t staId, BulkSendHelper client)   //jaishreeram added this function
+{
+  NS_LOG_FUNCTION (this << staId);
+  *m_os<<"Type of this client is: "<<typeid(client).name()<<std::endl;
+  ApplicationContainer clientApps = client.Install (m_apNodes);
+  // Stamp the send time on the packets sent by the client
+  clientApps.Get (0)->TraceConnectWithoutContext ("Tx", MakeCallback (&WifiDlOfdmaExample::StampApplicationTx, this));
+  m_clientApps_bulk.Add (clientApps);
+  m_staClientApps[staId] = clientApps.Get (0);
+  // m_clientApps_bulk.Stop (Seconds (m_warmup + m_simulationTime + 100)); // let clients be active for a long time jaishreeram commented
+}
+
+void
+WifiDlOfdmaExample::StartOnOffClient (std::size_t staId, OnOffHelper client)
+{
+  NS_LOG_FUNCTION (this << staId);
+  *m_os<<"Type of this client is: "<<typeid(client).name()<<std::endl;
+  ApplicationContainer clientApps = client.Install (m_apNodes);
+  // Stamp the send time on the packets sent by the client
+  clientApps.Get (0)->TraceConnectWithoutContext ("Tx", MakeCallback (&WifiDlOfdmaExample::StampApplicationTx, this));
+  m_clientApps.Add (clientApps);
+  m_staClientApps[staId] = clientApps.Get (0);
+  // m_clientApps.Stop (Seconds (m_warmup + m_simulationTime + 100)); // let clients be active for a long time jaishreeram commented
+}
+
+void
+WifiDlOfdmaExample::AddSourceFlow (std::size_t staId)
+{
+  NS_LOG_FUNCTION (this << staId);
+  // Same traffic as the client applications: on-off flows (1 s on, 1 s off) to
+  // odd stations and bulk TCP flows to even stations
+  if (staId % 2)
+    {
+      InetSocketAddress dest (m_staInterfaces.GetAddress (staId), m_port);
+      m_staFlows[staId] = m_source->AddFlow (MultiFlowSource::ON_OFF, dest, m_transport.compare ("Tcp") == 0,
+                                             DataRate (m_dataRate * 1e6), m_payloadSize, Seconds (1), Seconds (1));
+    }
+  else
+    {
+      InetSocketAddress dest (m_staInterfaces.GetAddress (staId), m_port_bulk);
+      m_staFlows[staId] = m_source->AddFlow (MultiFlowSource::BULK, dest, true, DataRate (0), 2048,
+                                             Seconds (0), Seconds (0), 10240000);
+    }
+}
+
+
+
+void
+WifiDlOfdmaExample::StartTraffic (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  *m_os<<"\n---Entering in StartTraffic()---\n";
+  m_profiler.StartPhase ("Warmup");
+  m_setupDuration = Simulator::Now ();
+  m_setupWallTime = std::chrono::duration<double> (std::chrono::steady_clock::now () - m_runStartWallTime).count ();
+  *m_os << "Association completed in " << m_setupDuration.GetSeconds () << " s of simulated time ("
+        << m_setupWallTime << " s of wall clock time)" << std::endl;
+
+  // Resolve the MAC, the BE Txop and the BE EDCA queue of the AP once, so that
+  // trace callbacks do not need to look them up on every event
+  Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice> (m_apDevices.Get (0));
+  PointerValue ptr;
+  m_apMac = DynamicCast<ApWifiMac> (dev->GetMac ());
+  m_apMac->GetAttribute ("BE_Txop", ptr);
+  m_apBeTxop = ptr.Get<QosTxop> ();
+  m_apBeQueue = m_apBeTxop->GetWifiMacQueue ();
+  m_apAddress = m_apMac->GetAddress ();
+  m_apMaxDelay = m_apBeQueue->GetMaxDelay ();
+
+  if (m_sampleInterval > 0)
+    {
+      StartSampling ();
+    }
+
+  if (!m_trafficTrace.empty ())
+    {
+      // Replay the packet trace to the sinks of the stations (stations with an even
+      // index run a TCP sink)
+      m_replay = CreateObject<TraceReplayClient> ();
+      m_replay->SetAttribute ("TraceFile", StringValue (m_trafficTrace));
+      m_replay->SetAttribute ("TimeScale", DoubleValue (m_traceTimeScale));
+      m_replay->SetAttribute ("Loop", BooleanValue (m_traceLoop));
+      std::string socketType = (m_transport.compare ("Tcp") == 0 ? "ns3::TcpSocketFactory" : "ns3::UdpSocketFactory");
+      for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+        {
+          m_replay->AddStation (InetSocketAddress (m_staInterfaces.GetAddress (i), (i % 2 ? m_port : m_port_bulk)),
+                                TypeId::LookupByName (i % 2 ? socketType : "ns3::TcpSocketFactory"));
+        }
+      // Stamp the send time on the packets sent by the replay client
+      m_replay->TraceConnectWithoutContext ("Tx", MakeCallback (&WifiDlOfdmaExample::StampApplicationTx, this));
+      m_apNodes.Get (0)->AddApplication (m_replay);
+    }
+
+  for (uint32_t i = 0; i < m_staNodes.GetN () && !m_multiFlowSource && m_trafficTrace.empty (); i++)
+    {
+      // stations of the same batch may associate in any order, hence client
+      // applications are looked up by station index
+      Ptr<Application> clientApp = m_staClientApps[i];
+      NS_ASSERT (clientApp != 0);
+
+      if(i%2==1){ //non bulk
+            *m_os<<"Starting Traffic for OnOffApplication [#"<<i<<"]"<<std::endl;
+            clientApp->SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
+            clientApp->SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
+        
+      }
+      else{ //bulk  jaishreeram
+        *m_os<<"Starting Traffic for BulkSendApplication [#"<<i<<"]"<<std::endl;
+        // clientApp->SetAttribute ("SendSize", UintegerValue(2048));    //jaishreeram commented
+        // clientApp->SetAttribute ("MaxBytes", UintegerValue(10240000));       
+      }
+    }
+
+  m_trafficStart = Simulator::Now ();
+  if (m_adaptiveWarmup)
+    {
+      StartWarmupDetection ();
+    }
+  else
+    {
+      m_warmupDuration = m_warmup;
+      Simulator::Schedule (Seconds (m_warmup), &WifiDlOfdmaExample::StartStatistics, this);
+    }
+  *m_os<<"\n---Exiting StartTraffic()---\n";
+}
+
+uint64_t
+WifiDlOfdmaExample::GetTotalRxBytes (void) const
+{
+  uint64_t totalRx = 0;
+  for (auto it = m_sinkApps.Begin (); it != m_sinkApps.End (); it++)
+    {
+      totalRx += DynamicCast<PacketSink> (*it)->GetTotalRx ();
+    }
+  for (auto it = m_sinkApps_bulk.Begin (); it != m_sinkApps_bulk.End (); it++)
+    {
+      totalRx += DynamicCast<PacketSink> (*it)->GetTotalRx ();
+    }
+  return totalRx;
+}
+
+double
+WifiDlOfdmaExample::GetMaxWarmup (void) const
+{
+  if (!m_adaptiveWarmup)
+    {
+      return m_warmup;
+    }
+  return (m_maxWarmup > 0 ? m_maxWarmup : m_simulationTime);
+}
+
+void
+WifiDlOfdmaExample::StartWarmupDetection (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (m_warmupSampleInterval == 0, "The warmup sample interval cannot be null");
+  NS_ABORT_MSG_IF (GetMaxWarmup () < m_warmup,
+                   "The maximum warmup duration cannot be less than the minimum warmup duration");
+  m_warmupTput.clear ();
+  m_warmupQueue.clear ();
+  m_warmupRx = GetTotalRxBytes ();
+  m_warmupSampleEvent = Simulator::Schedule (MilliSeconds (m_warmupSampleInterval),
+                                             &WifiDlOfdmaExample::SampleWarmup, this);
+  // if the end of the transient is not detected earlier, the warmup period lasts
+  // the maximum duration
+  m_warmupTimeoutEvent = Simulator::Schedule (Seconds (GetMaxWarmup ()), &WifiDlOfdmaExample::EndWarmup,
+                                              this, Seconds (-1));
+}
+
+void
+WifiDlOfdmaExample::SampleWarmup (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint64_t totalRx = GetTotalRxBytes ();
+  m_warmupTput.push_back ((totalRx - m_warmupRx) * 8. / (m_warmupSampleInterval * 1e3));
+  m_warmupQueue.push_back (m_apBeQueue->GetNPackets ());
+  m_warmupRx = totalRx;
+
+  // check the truncation points of both series every batch of 5 samples, once the
+  // minimum duration of the warmup period has elapsed
+  if (m_warmupTput.size () % 5 == 0 && Simulator::Now () - m_trafficStart >= Seconds (m_warmup))
+    {
+      int64_t tputTruncation = GetMser5Truncation (m_warmupTput);
+      int64_t queueTruncation = GetMser5Truncation (m_warmupQueue);
+      if (tputTruncation >= 0 && queueTruncation >= 0)
+        {
+          EndWarmup (MilliSeconds (std::max (tputTruncation, queueTruncation) * m_warmupSampleInterval));
+          return;
+        }
+    }
+  m_warmupSampleEvent = Simulator::Schedule (MilliSeconds (m_warmupSampleInterval),
+                                             &WifiDlOfdmaExample::SampleWarmup, this);
+}
+
+void
+WifiDlOfdmaExample::EndWarmup (Time truncation)
+{
+  NS_LOG_FUNCTION (this << truncation);
+  m_warmupSampleEvent.Cancel ();
+  m_warmupTimeoutEvent.Cancel ();
+  m_warmupDuration = (Simulator::Now () - m_trafficStart).GetSeconds ();
+  m_mserTruncation = truncation.GetSeconds ();
+  if (truncation.IsPositive ())
+    {
+      // the samples after the truncation point are discarded too, since statistics
+      // cannot be collected retroactively
+      *m_os << "Warmup period ended after " << m_warmupDuration << " s (MSER-5 truncation point at "
+            << m_mserTruncation << " s, " << m_warmupTput.size () << " samples)" << std::endl;
+    }
+  else
+    {
+      *m_os << "Warmup period ended after " << m_warmupDuration
+            << " s (MSER-5 did not detect the end of the transient)" << std::endl;
+    }
+  StartStatistics ();
+}
+
+void
+WifiDlOfdmaExample::StartStatistics (void)
+{
+  NS_LOG_FUNCTION (this);
+  *m_os<<"\n---Entering StartStatistics()---\n";
+  if (!m_variantList.empty () && m_variantIndex == VARIANT_NONE)
+    {
+      // Association and warmup are shared by all the variants, each of which
+      // runs the measurement period in a forked child process
+      ForkVariants ();
+      if (m_variantIndex == VARIANT_PARENT)
+        {
+          return;
+        }
+    }
+  m_profiler.StartPhase ("Measurement");
+  Ptr<WifiNetDevice> dev;
+  PointerValue ptr;
+
+  // Trace TXOP duration for BE on the AP
+  m_apBeTxop->TraceConnectWithoutContext ("TxopTrace", MakeCallback (&WifiDlOfdmaExample::TxopDuration, this));
+  // Trace expired MSDUs for BE on the AP
+  m_apBeQueue->TraceConnectWithoutContext ("Expired", MakeCallback (&WifiDlOfdmaExample::NotifyMsduExpired, this));
+  // Trace MSDUs dequeued from the BE EDCA queue on the AP
+  m_apBeQueue->TraceConnectWithoutContext ("Dequeue", MakeCallback (&WifiDlOfdmaExample::NotifyMsduDequeuedFromEdcaQueue, this));
+  if (!m_traceFile.empty ())
+    {
+      TraceHeader header {};
+      std::memcpy (header.magic, "WDOT", 4);
+      header.version = TRACE_VERSION;
+      header.nStations = m_nStations;
+      header.maxDelay = m_apMaxDelay.GetNanoSeconds ();
+      header.start = Simulator::Now ().GetNanoSeconds ();
+      m_trace.Open (m_traceFile, header);
+    }
+  // Trace PSDUs forwarded down to the PHY on the AP
+  m_airtime.assign (AIRTIME_N_CATEGORIES, 0.0);
+  m_staAirtime.assign (m_nStations, 0.0);
+  m_apBeTxop->GetLow ()->TraceConnectWithoutContext ("ForwardDown", MakeCallback (&WifiDlOfdmaExample::NotifyPsduForwardedDown, this));
+  // Trace TX failures on the AP
+  m_apMac->TraceConnectWithoutContext ("TxErrHeader", MakeCallback (&WifiDlOfdmaExample::NotifyTxFailed, this));
+  // Retrieve the number of bytes received by each station until the end of the warmup period
+  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+    {
+      if(i%2)
+      m_rxStart[i] = DynamicCast<PacketSink> (m_sinkApps.Get (i/2))->GetTotalRx ();
+      else m_rxStart[i] = DynamicCast<PacketSink> (m_sinkApps_bulk.Get (i/2))->GetTotalRx ();
+    }
+  // Retrieve the number of packets and bytes sent by each flow of the source until the end of the warmup period
+  for (uint32_t i = 0; i < m_staNodes.GetN () && m_multiFlowSource; i++)
+    {
+      m_sourceTxPackets[i] = m_source->GetFlowTxPackets (m_staFlows[i]);
+      m_sourceTxBytes[i] = m_source->GetFlowTxBytes (m_staFlows[i]);
+    }
+
+  // Trace PSDUs forwarded down to the PHY on each station
+  for (uint32_t i = 0; i < m_staDevices.GetN (); i++)
+    {
+      dev = DynamicCast<WifiNetDevice> (m_staDevices.Get (i));
+      dev->GetMac ()->GetAttribute ("BE_Txop", ptr);
+      ptr.Get<QosTxop> ()->GetLow ()->TraceConnectWithoutContext ("ForwardDown",
+                                                                  MakeCallback (&WifiDlOfdmaExample::NotifyPsduForwardedDown, this));
+    }
+
+  if (m_latencyMode == "App")
+    {
+      // Trace packets received by the packet sink of each station
+      for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+        {
+          Ptr<Application> sinkApp = (i % 2 ? m_sinkApps.Get (i / 2) : m_sinkApps_bulk.Get (i / 2));
+          sinkApp->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&SinkRxTrace, this, static_cast<std::size_t> (i)));
+        }
+    }
+  else
+    {
+      // Trace packets sent by the AP and received by each station at the MAC layer
+      m_apMac->TraceConnectWithoutContext ("MacTx", MakeCallback (&WifiDlOfdmaExample::NotifyApplicationTx, this));
+      for (uint32_t i = 0; i < m_staDevices.GetN (); i++)
+        {
+          DynamicCast<WifiNetDevice> (m_staDevices.Get (i))->GetMac ()
+            ->TraceConnectWithoutContext ("MacRx", MakeBoundCallback (&MacRxTrace, this, static_cast<std::size_t> (i)));
+        }
+    }
+
+  m_statisticsStart = Simulator::Now ();
+  if (m_targetPrecision > 0)
+    {
+      // the measurement period may end earlier if the results converge
+      m_batchTput.clear ();
+      m_batchLatency.clear ();
+      m_batchRx = std::accumulate (m_rxStart.begin (), m_rxStart.end (), 0ull);
+      m_batchLatencySum = 0.0;
+      m_batchLatencyCount = 0;
+      m_batchEvent = Simulator::Schedule (MicroSeconds (m_batchDuration * 1000), &WifiDlOfdmaExample::EndBatch, this);
+    }
+  m_stopStatisticsEvent = Simulator::Schedule (Seconds (m_simulationTime), &WifiDlOfdmaExample::StopStatistics, this);
+  *m_os<<"\n---Exiting StartStatistics()---\n";
+}
+
+void
+WifiDlOfdmaExample::ForkVariants (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  NS_ABORT_MSG_IF (mkdir (m_variantOutput.c_str (), 0755) != 0 && errno != EEXIST,
+                   "Cannot create directory " << m_variantOutput << ": " << std::strerror (errno));
+  std::string tableName = m_variantOutput + "/results.csv";
+  std::ofstream table (tableName, std::ios::trunc);
+  NS_ABORT_MSG_IF (!table.is_open (), "Cannot open results table " << tableName);
+  table << "variant," << GetSummaryHeader () << std::endl;
+
+  WorkerPool pool (m_variantJobs);
+
+  *m_os << "Variants = " << m_variantList.size () << std::endl
+        << "Workers = " << pool.GetNJobs () << std::endl << std::endl;
+
+  std::size_t next = 0;
+  std::size_t nCompleted = 0;
+
+  while (next < m_variantList.size () || !pool.IsIdle ())
+    {
+      if (next < m_variantList.size () && pool.CanSpawn ())
+        {
+          if (m_timeSeries.is_open ())
+            {
+              m_timeSeries.flush ();
+            }
+          if (pool.Spawn (next, GetVariantFileName (next, ".log")))
+            {
+              // Child process: return to the simulation and run the measurement
+              // period with the settings of this variant
+              StartVariant (next);
+              return;
+            }
+          next++;
+          continue;
+        }
+
+      std::size_t index;
+      bool success = pool.Reap (index);
+
+      std::string rowName = GetVariantFileName (index, ".row");
+      std::ifstream row (rowName);
+      std::string summary;
+      if (success && std::getline (row, summary))
+        {
+          table << "\"" << m_variants[index] << "\"," << summary << std::endl;
+          nCompleted++;
+          *m_os << "Completed [" << m_variants[index] << "]" << std::endl;
+        }
+      else
+        {
+          *m_os << "FAILED [" << m_variants[index] << "], see " << GetVariantFileName (index, ".log") << std::endl;
+        }
+      std::remove (rowName.c_str ());
+    }
+
+  *m_os << std::endl << "Completed variants = " << nCompleted << std::endl
+        << "Failed variants = " << m_variantList.size () - nCompleted << std::endl;
+
+  // The parent process does not run any measurement period
+  m_variantIndex = VARIANT_PARENT;
+  if (m_timeSeries.is_open ())
+    {
+      m_sampleEvent.Cancel ();
+      m_timeSeries.close ();
+    }
+  Simulator::Stop ();
+}
+
+void
+WifiDlOfdmaExample::StartVariant (std::size_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+  m_variantIndex = index;
+
+  *m_os << "Variant = " << m_variants[index] << std::endl;
+
+  // Per-run output files are specific to each variant
+  if (m_timeSeries.is_open ())
+    {
+      // the time series of the shared warmup is copied to the file of this variant
+      m_timeSeries.close ();
+      std::string timeSeriesFile = GetVariantFileName (index, ".ts.csv");
+      {
+        std::ifstream src (m_timeSeriesFile, std::ios::binary);
+        std::ofstream dst (timeSeriesFile, std::ios::binary | std::ios::trunc);
+        dst << src.rdbuf ();
+      }
+      m_timeSeriesFile = timeSeriesFile;
+      m_timeSeries.open (m_timeSeriesFile, std::ios::out | std::ios::app);
+    }
+  RenameOutputFiles (GetVariantFileName (index, ""));
+
+  for (auto& setting : m_variantList[index])
+    {
+      const std::string& name = setting.first;
+      std::istringstream value (setting.second);
+
+      NS_ABORT_MSG_IF ((name == "dataRate" || name == "payloadSize") && !m_trafficTrace.empty (),
+                       "The " << name << " of the packet trace being replayed cannot be changed");
+      if (name == "dataRate")
+        {
+          value >> m_dataRate;
+          for (uint32_t i = 1; i < m_nStations; i += 2)
+            {
+              if (m_multiFlowSource)
+                {
+                  m_source->SetFlowRate (m_staFlows[i], DataRate (m_dataRate * 1e6));
+                  continue;
+                }
+              m_staClientApps[i]->SetAttribute ("DataRate", DataRateValue (DataRate (m_dataRate * 1e6)));
+            }
+        }
+      else if (name == "payloadSize")
+        {
+          value >> m_payloadSize;
+          for (uint32_t i = 1; i < m_nStations; i += 2)
+            {
+              if (m_multiFlowSource)
+                {
+                  m_source->SetFlowPacketSize (m_staFlows[i], m_payloadSize);
+                  continue;
+                }
+              m_staClientApps[i]->SetAttribute ("PacketSize", UintegerValue (m_payloadSize));
+            }
+        }
+      else if (name == "txopLimit")
+        {
+          value >> m_txopLimit;
+          m_apBeTxop->SetTxopLimit (MicroSeconds (m_txopLimit));
+        }
+      else if (name == "msduLifetime")
+        {
+          value >> m_msduLifetime;
+          m_apBeQueue->SetMaxDelay (MilliSeconds (m_msduLifetime));
+          m_apMaxDelay = m_apBeQueue->GetMaxDelay ();
+        }
+      else if (name == "maxAmsduSize")
+        {
+          value >> m_maxAmsduSize;
+          m_apMac->SetAttribute ("BE_MaxAmsduSize", UintegerValue (m_maxAmsduSize));
+        }
+      else if (name == "maxAmpduSize")
+        {
+          value >> m_maxAmpduSize;
+          m_apMac->SetAttribute ("BE_MaxAmpduSize", UintegerValue (m_maxAmpduSize));
+        }
+      else if (name == "forceDlOfdma")
+        {
+          std::string flag;
+          value >> flag;
+          if (flag == "1" || flag == "true")
+            {
+              m_forceDlOfdma = true;
+            }
+          else if (flag == "0" || flag == "false")
+            {
+              m_forceDlOfdma = false;
+            }
+          else
+            {
+              value.setstate (std::ios::failbit);
+            }
+          Ptr<OfdmaManager> ofdmaManager = m_apMac->GetObject<OfdmaManager> ();
+          NS_ABORT_MSG_IF (ofdmaManager == 0, "forceDlOfdma requires DL OFDMA to be enabled");
+          ofdmaManager->SetAttribute ("ForceDlOfdma", BooleanValue (m_forceDlOfdma));
+        }
+      else if (name == "simulationTime")
+        {
+          // applications and the simulation are stopped based on the configured
+          // simulation time, which is the longest measurement period allowed
+          double simulationTime;
+          value >> simulationTime;
+          NS_ABORT_MSG_IF (simulationTime > m_simulationTime,
+                           "The simulationTime of a variant cannot exceed the configured one");
+          m_simulationTime = simulationTime;
+        }
+      NS_ABORT_MSG_IF (value.fail (), "Invalid value for " << name << " in variant " << m_variants[index]);
+    }
+}
+
+void
+WifiDlOfdmaExample::RenameOutputFiles (const std::string& prefix)
+{
+  NS_LOG_FUNCTION (this << prefix);
+  m_flowMonitorFile = prefix + "." + m_flowMonitorFile.substr (m_flowMonitorFile.rfind ('/') + 1);
+  if (!m_traceFile.empty ())
+    {
+      m_traceFile = prefix + "." + m_traceFile.substr (m_traceFile.rfind ('/') + 1);
+    }
+}
+
+std::string
+WifiDlOfdmaExample::GetVariantFileName (std::size_t index, std::string extension) const
+{
+  std::ostringstream oss;
+  oss << m_variantOutput << "/variant-" << std::setfill ('0') << std::setw (5) << index << extension;
+  return oss.str ();
+}
+
+void
+WifiDlOfdmaExample::EndBatch (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // Throughput and average latency of the batch that just ended
+  uint64_t totalRx = 0;
+  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+    {
+      totalRx += DynamicCast<PacketSink> (i % 2 ? m_sinkApps.Get (i / 2) : m_sinkApps_bulk.Get (i / 2))->GetTotalRx ();
+    }
+  m_batchTput.push_back ((totalRx - m_batchRx) * 8. / (m_batchDuration * 1e3));
+  m_batchRx = totalRx;
+
+  double latencySum = 0.0;  // milliseconds
+  uint64_t latencyCount = 0;
+  for (auto& sta : m_appLatencyMap)
+    {
+      latencySum += sta.second.GetMean ().ToDouble (Time::MS) * sta.second.GetCount ();
+      latencyCount += sta.second.GetCount ();
+    }
+  if (latencyCount > m_batchLatencyCount)
+    {
+      m_batchLatency.push_back ((latencySum - m_batchLatencySum) / (latencyCount - m_batchLatencyCount));
+    }
+  m_batchLatencySum = latencySum;
+  m_batchLatencyCount = latencyCount;
+
+  // The measurement period can end when the confidence intervals of both the
+  // throughput and the latency are narrow enough (latency is not considered if
+  // no latency sample has been taken)
+  double tputMean = 0.0, tputHalfWidth = 0.0, latencyMean = 0.0, latencyHalfWidth = 0.0;
+  bool converged = false;
+  if (m_batchTput.size () >= m_minBatches)
+    {
+      GetConfidenceInterval (m_batchTput, tputMean, tputHalfWidth);
+      converged = (tputMean > 0 && tputHalfWidth / tputMean < m_targetPrecision);
+      if (converged && latencyCount > 0)
+        {
+          converged = (m_batchLatency.size () >= m_minBatches);
+          if (converged)
+            {
+              GetConfidenceInterval (m_batchLatency, latencyMean, latencyHalfWidth);
+              converged = (latencyMean > 0 && latencyHalfWidth / latencyMean < m_targetPrecision);
+            }
+        }
+    }
+
+  if (!converged)
+    {
+      m_batchEvent = Simulator::Schedule (MicroSeconds (m_batchDuration * 1000), &WifiDlOfdmaExample::EndBatch, this);
+      return;
+    }
+
+  m_converged = true;
+  // throughput is computed over the actual duration of the measurement period
+  m_simulationTime = (Simulator::Now () - m_statisticsStart).GetSeconds ();
+  *m_os << "Converged after " << m_simulationTime << " s (" << m_batchTput.size () << " batches): "
+        << "throughput " << tputMean << " +/- " << tputHalfWidth << " Mbps";
+  if (latencyCount > 0)
+    {
+      *m_os << ", latency " << latencyMean << " +/- " << latencyHalfWidth << " ms";
+    }
+  *m_os << std::endl;
+
+  m_stopStatisticsEvent.Cancel ();
+  StopStatistics ();
+}
+
+void
+WifiDlOfdmaExample::StopStatistics (void)
+{
+  NS_LOG_FUNCTION (this);
+  *m_os<<"\n---Entering StopStatistics()---\n";
+  Ptr<WifiNetDevice> dev;
+  PointerValue ptr;
+
+  if (m_sampleInterval > 0)
+    {
+      Sample ();  // the last window ends with the measurement period
+      StopSampling ();
+    }
+
+  // Stop tracing TXOP duration for BE on the AP
+  m_apBeTxop->TraceDisconnectWithoutContext ("TxopTrace", MakeCallback (&WifiDlOfdmaExample::TxopDuration, this));
+  // Stop tracing expired MSDUs for BE on the AP
+  m_apBeQueue->TraceDisconnectWithoutContext ("Expired", MakeCallback (&WifiDlOfdmaExample::NotifyMsduExpired, this));
+  // Stop tracing MSDUs dequeued from the BE EDCA queue on the AP
+  m_apBeQueue->TraceDisconnectWithoutContext ("Dequeue", MakeCallback (&WifiDlOfdmaExample::NotifyMsduDequeuedFromEdcaQueue, this));
+  // Stop tracing PSDUs forwarded down to the PHY on the AP
+  m_apBeTxop->GetLow ()->TraceDisconnectWithoutContext ("ForwardDown", MakeCallback (&WifiDlOfdmaExample::NotifyPsduForwardedDown, this));
+  // Stop tracing TX failures on the AP
+  m_apMac->TraceDisconnectWithoutContext ("TxErrHeader", MakeCallback (&WifiDlOfdmaExample::NotifyTxFailed, this));
+  m_trace.Close ();
+  // Retrieve the number of bytes received by each station until the end of the simulation period
+  // std::cout<<"I have reached here 0\n";
+  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+    {
+      if(i%2)
+      // std::cout<<"I have reached here\n";
+        m_rxStop[i] = DynamicCast<PacketSink> (m_sinkApps.Get (i/2))->GetTotalRx ();
+        // std::cout<<"I exit from here\n";
+      else m_rxStop[i] = DynamicCast<PacketSink> (m_sinkApps_bulk.Get (i/2))->GetTotalRx ();
+    }
+    // std::cout<<"I have reached here 1 \n";
+
+  // Packets and bytes sent by each flow of the source during the simulation period
+  for (uint32_t i = 0; i < m_staNodes.GetN () && m_multiFlowSource; i++)
+    {
+      m_sourceTxPackets[i] = m_source->GetFlowTxPackets (m_staFlows[i]) - m_sourceTxPackets[i];
+      m_sourceTxBytes[i] = m_source->GetFlowTxBytes (m_staFlows[i]) - m_sourceTxBytes[i];
+    }
+  if (m_multiFlowSource)
+    {
+      m_source->Dispose ();
+    }
+
+  if (m_replay != 0)
+    {
+      m_replay->Dispose ();
+    }
+
+  // (Brutally) stop client applications
+  for (uint32_t i = 0; i < m_staNodes.GetN () && !m_multiFlowSource && m_replay == 0; i++)
+    {
+      *m_os<<"Brutally stopping station #"<<i<<"\n";
+      m_staClientApps[i]->Dispose ();
+    }
+    // std::cout<<"I have reached here 2 \n";
+
+  // Stop tracing PSDUs forwarded down to the PHY on each station
+  for (uint32_t i = 0; i < m_staDevices.GetN (); i++)
+    {
+      
+      dev = DynamicCast<WifiNetDevice> (m_staDevices.Get (i));
+      dev->GetMac ()->GetAttribute ("BE_Txop", ptr);
+      ptr.Get<QosTxop> ()->GetLow ()->TraceDisconnectWithoutContext ("ForwardDown",
+                                                                     MakeCallback (&WifiDlOfdmaExample::NotifyPsduForwardedDown, this));
+      
+    }
+  // std::cout<<"I have reached here 3 \n";
+  if (m_latencyMode == "App")
+    {
+      // Stop tracing packets received by the packet sink of each station
+      for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+        {
+          Ptr<Application> sinkApp = (i % 2 ? m_sinkApps.Get (i / 2) : m_sinkApps_bulk.Get (i / 2));
+          sinkApp->TraceDisconnectWithoutContext ("Rx", MakeBoundCallback (&SinkRxTrace, this, static_cast<std::size_t> (i)));
+        }
+    }
+  else
+    {
+      // Stop tracing packets sent by the AP and received by each station at the MAC layer
+      m_apMac->TraceDisconnectWithoutContext ("MacTx", MakeCallback (&WifiDlOfdmaExample::NotifyApplicationTx, this));
+      for (uint32_t i = 0; i < m_staDevices.GetN (); i++)
+        {
+          DynamicCast<WifiNetDevice> (m_staDevices.Get (i))->GetMac ()
+            ->TraceDisconnectWithoutContext ("MacRx", MakeBoundCallback (&MacRxTrace, this, static_cast<std::size_t> (i)));
+        }
+    }
+
+  if (m_targetPrecision > 0)
+    {
+      // nothing is measured after the measurement period, hence there is no need
+      // to keep simulating
+      m_batchEvent.Cancel ();
+      Simulator::Stop ();
+    }
+  else
+    {
+      // the simulation continues until the scheduled stop time
+      m_profiler.StartPhase ("Tail");
+    }
+  *m_os<<"\n---Exiting StopStatistics()---\n";
+}
+
+void
+WifiDlOfdmaExample::StartSampling (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_timeSeries.open (m_timeSeriesFile, std::ios::out | std::ios::trunc);
+  NS_ABORT_MSG_IF (!m_timeSeries.is_open (), "Cannot open time series file " << m_timeSeriesFile);
+
+  m_staSinks.resize (m_nStations);
+  m_sampleRx.assign (m_nStations, 0);
+  m_sampleFailed.assign (m_nStations, 0);
+  m_sampleExpired.assign (m_nStations, 0);
+  m_sampleTxops = 0;
+  m_sampleTxopTime = Seconds (0);
+
+  // One row per window, the per-station columns are grouped by metric. The TXOP
+  // columns refer to the TXOPs ended in the window
+  m_timeSeries << "timeMs,queuePackets,queueBytes,txops,txopTimeMs";
+  for (const char *metric : {"rxBytes", "failed", "expired"})
+    {
+      for (uint32_t i = 0; i < m_nStations; i++)
+        {
+          m_timeSeries << "," << metric << "_STA_" << i;
+        }
+    }
+  m_timeSeries << '\n';
+
+  for (uint32_t i = 0; i < m_nStations; i++)
+    {
+      m_staSinks[i] = DynamicCast<PacketSink> (i % 2 ? m_sinkApps.Get (i / 2) : m_sinkApps_bulk.Get (i / 2));
+      m_sampleRx[i] = m_staSinks[i]->GetTotalRx ();
+    }
+
+  // These traces are also connected during the measurement period, which only
+  // counts the events of that period
+  m_apBeTxop->TraceConnectWithoutContext ("TxopTrace", MakeCallback (&WifiDlOfdmaExample::SampleTxop, this));
+  m_apBeQueue->TraceConnectWithoutContext ("Expired", MakeCallback (&WifiDlOfdmaExample::SampleMsduExpired, this));
+  m_apMac->TraceConnectWithoutContext ("TxErrHeader", MakeCallback (&WifiDlOfdmaExample::SampleTxFailed, this));
+
+  m_sampleEvent = Simulator::Schedule (MicroSeconds (m_sampleInterval * 1000), &WifiDlOfdmaExample::Sample, this);
+}
+
+void
+WifiDlOfdmaExample::Sample (void)
+{
+  m_timeSeries << Simulator::Now ().ToDouble (Time::MS) << "," << m_apBeQueue->GetNPackets ()
+               << "," << m_apBeQueue->GetNBytes () << "," << m_sampleTxops
+               << "," << m_sampleTxopTime.ToDouble (Time::MS);
+  for (uint32_t i = 0; i < m_nStations; i++)
+    {
+      uint64_t totalRx = m_staSinks[i]->GetTotalRx ();
+      m_timeSeries << "," << totalRx - m_sampleRx[i];
+      m_sampleRx[i] = totalRx;
+    }
+  for (uint32_t i = 0; i < m_nStations; i++)
+    {
+      m_timeSeries << "," << m_sampleFailed[i];
+    }
+  for (uint32_t i = 0; i < m_nStations; i++)
+    {
+      m_timeSeries << "," << m_sampleExpired[i];
+    }
+  m_timeSeries << '\n';
+
+  std::fill (m_sampleFailed.begin (), m_sampleFailed.end (), 0);
+  std::fill (m_sampleExpired.begin (), m_sampleExpired.end (), 0);
+  m_sampleTxops = 0;
+  m_sampleTxopTime = Seconds (0);
+
+  m_sampleEvent = Simulator::Schedule (MicroSeconds (m_sampleInterval * 1000), &WifiDlOfdmaExample::Sample, this);
+}
+
+void
+WifiDlOfdmaExample::StopSampling (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_sampleEvent.Cancel ();
+  m_apBeTxop->TraceDisconnectWithoutContext ("TxopTrace", MakeCallback (&WifiDlOfdmaExample::SampleTxop, this));
+  m_apBeQueue->TraceDisconnectWithoutContext ("Expired", MakeCallback (&WifiDlOfdmaExample::SampleMsduExpired, this));
+  m_apMac->TraceDisconnectWithoutContext ("TxErrHeader", MakeCallback (&WifiDlOfdmaExample::SampleTxFailed, this));
+  m_timeSeries.close ();
+  m_staSinks.clear ();
+}
+
+void
+WifiDlOfdmaExample::SampleTxFailed (const WifiMacHeader& hdr)
+{
+  auto it = m_staIndexByAddress.find (AddressToInteger (hdr.GetAddr1 ()));
+  if (it != m_staIndexByAddress.end ())
+    {
+      m_sampleFailed[it->second]++;
+    }
+}
+
+void
+WifiDlOfdmaExample::SampleMsduExpired (Ptr<const WifiMacQueueItem> item)
+{
+  auto it = m_staIndexByAddress.find (AddressToInteger (item->GetHeader ().GetAddr1 ()));
+  if (it != m_staIndexByAddress.end ())
+    {
+      m_sampleExpired[it->second]++;
+    }
+}
+
+void
+WifiDlOfdmaExample::SampleTxop (Time startTime, Time duration)
+{
+  m_sampleTxops++;
+  m_sampleTxopTime += duration;
+}
+
+void
+WifiDlOfdmaExample::NotifyTxFailed (const WifiMacHeader& hdr)
+{
+  m_stats.NotifyTxFailed (GetStaIndex (hdr.GetAddr1 ()));
+  if (m_trace.IsOpen ())
+    {
+      TraceEvent (TraceRecord::TX_FAILED, hdr.GetAddr1 ());
+    }
+}
+
+void
+WifiDlOfdmaExample::NotifyMsduExpired (Ptr<const WifiMacQueueItem> item)
+{
+  m_stats.NotifyMsduExpired (GetStaIndex (item->GetHeader ().GetAddr1 ()));
+  if (m_trace.IsOpen ())
+    {
+      TraceEvent (TraceRecord::EXPIRED, item->GetHeader ().GetAddr1 ());
+    }
+}
+
+void
+WifiDlOfdmaExample::NotifyMsduDequeuedFromEdcaQueue (Ptr<const WifiMacQueueItem> item)
+{
+  if (m_trace.IsOpen ())
+    {
+      TraceEvent (TraceRecord::DEQUEUE, item->GetHeader ().GetAddr1 (), item->GetTimeStamp ().GetNanoSeconds ());
+    }
+  m_stats.NotifyMsduDequeued (GetStaIndex (item->GetHeader ().GetAddr1 ()), item->GetTimeStamp (),
+                              m_apMaxDelay, Simulator::Now ());
+}
+
+void
+WifiDlOfdmaExample::NotifyPsduForwardedDown (WifiPsduMap psduMap, WifiTxVector txVector)
+{
+  Time duration = ChargeAirtime (psduMap, txVector);
+
+  if (psduMap.size () == 1 && psduMap.begin ()->second->GetAddr1 () == m_apAddress
+      && psduMap.begin ()->second->GetHeader (0).IsQosData ())
+    {
+      // Uplink frame
+      if (txVector.GetPreambleType () == WIFI_PREAMBLE_HE_TB)
+        {
+          // HE TB PPDU (the duration of the PPDU was looked up to charge its airtime)
+          m_stats.NotifyHeTbPpdu (GetStaIndex (psduMap.begin ()->second->GetAddr2 ()), duration);
+        }
+    }
+  // Downlink frame
+  else if (psduMap.begin ()->second->GetHeader (0).IsQosData ())
+    {
+      for (auto& psdu : psduMap)
+        {
+          m_stats.NotifyDlPsdu (GetStaIndex (psdu.second->GetAddr1 ()), psdu.second->GetSize ());
+        }
+
+      // DL MU PPDU
+      if (txVector.GetPreambleType () == WIFI_PREAMBLE_HE_MU)
+        {
+          std::vector<std::pair<std::size_t, uint32_t> > users;
+          for (auto& userInfo : txVector.GetHeMuUserInfoMap ())
+            {
+              auto psduIt = psduMap.find (userInfo.first);
+              // the station that was assigned this RU may not have been sent a PSDU
+              users.push_back (std::make_pair (GetStaIndexByAid (userInfo.first),
+                                               psduIt == psduMap.end () ? 0 : psduIt->second->GetSize ()));
+            }
+          m_stats.NotifyDlMuPpdu (users);
+        }
+    }
+  else if (psduMap.size () == 1 && psduMap.begin ()->second->GetHeader (0).IsTrigger ())
+    {
+      CtrlTriggerHeader trigger;
+      psduMap.begin ()->second->GetPayload (0)->PeekHeader (trigger);
+
+      if (trigger.IsBasic ())
+        {
+          WifiTxVector heTbTxVector = trigger.GetHeTbTxVector (trigger.begin ()->GetAid12 ());
+          m_stats.NotifyBasicTf (m_txDurationCache.GetTfUlDuration (trigger.GetUlLength (), heTbTxVector),
+                                 trigger.GetNUserInfoFields ());
+
+          for (auto& userInfo : trigger)
+            {
+              m_stats.NotifySolicitedSta (GetStaIndexByAid (userInfo.GetAid12 ()));
+            }
+        }
+    }
+
+  if (m_trace.IsOpen ())
+    {
+      TracePpdu (psduMap, txVector, duration);
+    }
+}
+Time
+WifiDlOfdmaExample::ChargeAirtime (const WifiPsduMap& psduMap, const WifiTxVector& txVector)
+{
+  TxDurationCache::PpduDurations durations = m_txDurationCache.GetPpduDurations (psduMap, txVector);
+  double duration = durations.duration.GetSeconds ();
+  // time of the data symbols (the remainder of the PPDU duration is PHY overhead)
+  double dataTime = std::max (duration - durations.overhead.GetSeconds (), 0.0);
+  bool isMu = (txVector.GetPreambleType () == WIFI_PREAMBLE_HE_MU
+               || txVector.GetPreambleType () == WIFI_PREAMBLE_HE_TB);
+  uint16_t channelTones = GetNTones (GetEqualSizedRuType (txVector.GetChannelWidth (), 1));
+
+  uint32_t maxSize = 0;
+  for (auto& psdu : psduMap)
+    {
+      maxSize = std::max (maxSize, psdu.second->GetSize ());
+    }
+
+  double allocatedShare = 0.0;
+  for (auto& psdu : psduMap)
+    {
+      // the users of an MU PPDU are charged the share of the channel occupied by their RU
+      double share = 1.0;
+      auto userInfoIt = txVector.GetHeMuUserInfoMap ().find (psdu.first);
+      if (isMu && userInfoIt != txVector.GetHeMuUserInfoMap ().end ())
+        {
+          share = static_cast<double> (GetNTones (userInfoIt->second.ru.ruType)) / channelTones;
+        }
+      allocatedShare += share;
+      double airtime = duration * share;
+
+      const WifiMacHeader& hdr = psdu.second->GetHeader (0);
+      std::vector<std::size_t> stas;
+      auto staIt = m_staIndexByAddress.find (AddressToInteger (hdr.GetAddr1 ()));
+      if (staIt == m_staIndexByAddress.end ())
+        {
+          staIt = m_staIndexByAddress.find (AddressToInteger (hdr.GetAddr2 ()));
+        }
+      if (staIt != m_staIndexByAddress.end ())
+        {
+          stas.push_back (staIt->second);
+        }
+
+      if (hdr.IsQosData ())
+        {
+          // PSDUs shorter than the longest one are padded
+          double payload = dataTime * share * psdu.second->GetSize () / maxSize;
+          m_airtime[AIRTIME_PAYLOAD] += payload;
+          m_airtime[AIRTIME_PHY_OVERHEAD] += airtime - payload;
+        }
+      else if (hdr.IsTrigger ())
+        {
+          CtrlTriggerHeader trigger;
+          psdu.second->GetPayload (0)->PeekHeader (trigger);
+          m_airtime[trigger.IsMuBar () ? AIRTIME_MU_BAR : AIRTIME_TRIGGER] += airtime;
+          // broadcast Trigger Frames are charged to the solicited stations
+          if (stas.empty ())
+            {
+              for (auto& userInfo : trigger)
+                {
+                  uint16_t aid = userInfo.GetAid12 ();
+                  if (aid < m_staIndexByAid.size () && m_staIndexByAid[aid] < m_nStations)
+                    {
+                      stas.push_back (m_staIndexByAid[aid]);
+                    }
+                }
+            }
+        }
+      else if (hdr.IsBlockAck () || hdr.IsBlockAckReq () || hdr.IsAck ())
+        {
+          m_airtime[AIRTIME_BLOCK_ACK] += airtime;
+        }
+      else
+        {
+          m_airtime[AIRTIME_OTHER] += airtime;
+        }
+
+      for (auto sta : stas)
+        {
+          m_staAirtime[sta] += airtime / stas.size ();
+        }
+    }
+
+  // RUs of a DL MU PPDU that are not assigned to any station are PHY overhead
+  if (txVector.GetPreambleType () == WIFI_PREAMBLE_HE_MU && allocatedShare < 1.0)
+    {
+      m_airtime[AIRTIME_PHY_OVERHEAD] += duration * (1.0 - allocatedShare);
+    }
+  return durations.duration;
+}
+
+void
+WifiDlOfdmaExample::TracePpdu (const WifiPsduMap& psduMap, const WifiTxVector& txVector, Time duration)
+{
+  TraceRecord record {};
+  record.time = Simulator::Now ().GetNanoSeconds ();
+  record.value = duration.GetNanoSeconds ();
+  record.ppdu = m_nTracedPpdus++;
+  record.type = TraceRecord::PSDU;
+  record.preamble = txVector.GetPreambleType ();
+  record.uplink = (psduMap.begin ()->second->GetAddr1 () == m_apAddress);
+
+  for (auto& psdu : psduMap)
+    {
+      const WifiMacHeader& hdr = psdu.second->GetHeader (0);
+      auto staIt = m_staIndexByAddress.find (AddressToInteger (record.uplink ? psdu.second->GetAddr2 ()
+                                                                             : psdu.second->GetAddr1 ()));
+      record.sta = (staIt != m_staIndexByAddress.end () ? staIt->second : TraceRecord::NO_STA);
+      record.size = psdu.second->GetSize ();
+      CtrlTriggerHeader trigger;
+
+      if (hdr.IsQosData ())
+        {
+          record.kind = TraceRecord::QOS_DATA;
+        }
+      else if (hdr.IsTrigger ())
+        {
+          psdu.second->GetPayload (0)->PeekHeader (trigger);
+          record.kind = (trigger.IsBasic () ? TraceRecord::BASIC_TF
+                                            : (trigger.IsMuBar () ? TraceRecord::MU_BAR : TraceRecord::OTHER_TF));
+        }
+      else if (hdr.IsBlockAck () || hdr.IsBlockAckReq () || hdr.IsAck ())
+        {
+          record.kind = TraceRecord::BLOCK_ACK;
+        }
+      else
+        {
+          record.kind = TraceRecord::OTHER;
+        }
+      m_trace.Write (record);
+
+      if (record.kind == TraceRecord::BASIC_TF)
+        {
+          // the UL Length duration has just been computed by NotifyPsduForwardedDown
+          TraceRecord user = record;
+          user.type = TraceRecord::TF_USER;
+          user.value = m_stats.GetTfUlLength ().GetNanoSeconds ();
+          user.size = trigger.GetNUserInfoFields ();
+          for (auto& userInfo : trigger)
+            {
+              uint16_t aid = userInfo.GetAid12 ();
+              user.sta = (aid < m_staIndexByAid.size () && m_staIndexByAid[aid] < m_nStations
+                          ? m_staIndexByAid[aid] : TraceRecord::NO_STA);
+              m_trace.Write (user);
+            }
+        }
+    }
+
+  // RUs of a DL MU PPDU assigned to stations that were not sent a PSDU
+  if (txVector.GetPreambleType () == WIFI_PREAMBLE_HE_MU)
+    {
+      record.kind = TraceRecord::QOS_DATA;
+      record.size = 0;
+      for (auto& userInfo : txVector.GetHeMuUserInfoMap ())
+        {
+          if (psduMap.find (userInfo.first) == psduMap.end ())
+            {
+              record.sta = GetStaIndexByAid (userInfo.first);
+              m_trace.Write (record);
+            }
+        }
+    }
+}
+
+void
+WifiDlOfdmaExample::TraceEvent (TraceRecord::Type type, Mac48Address address, int64_t value)
+{
+  TraceRecord record {};
+  record.time = Simulator::Now ().GetNanoSeconds ();
+  record.value = value;
+  record.type = type;
+  auto staIt = m_staIndexByAddress.find (AddressToInteger (address));
+  record.sta = (staIt != m_staIndexByAddress.end () ? staIt->second : TraceRecord::NO_STA);
+  m_trace.Write (record);
+}
+
+const char *
+WifiDlOfdmaExample::GetAirtimeCategoryName (std::size_t category)
+{
+  static const char *names[] = {"payload", "phyOverhead", "triggerFrames", "muBar", "blockAck", "other", "idle"};
+  NS_ASSERT (category < AIRTIME_N_CATEGORIES);
+  return names[category];
+}
+
+double
+WifiDlOfdmaExample::GetAirtimeFairness (void) const
+{
+  double sum = 0.0;
+  double sumSquares = 0.0;
+  for (auto airtime : m_staAirtime)
+    {
+      sum += airtime;
+      sumSquares += airtime * airtime;
+    }
+  return (sumSquares > 0 ? sum * sum / (m_staAirtime.size () * sumSquares) : 0.0);
+}
+
+
+void
+WifiDlOfdmaExample::TxopDuration (Time startTime, Time duration)
+{
+  if (duration > m_maxTxop)
+    {
+      m_maxTxop = duration;
+    }
+}
+
+void
+WifiDlOfdmaExample::NotifyApplicationTx (Ptr<const Packet> p)
+{
+  if (p->GetSize () < m_payloadSize)
+    {
+      return;
+    }
+  m_appPacketTxMap.insert (std::make_pair (p->GetUid (), Simulator::Now ()));
+}
+
+void
+WifiDlOfdmaExample::NotifyApplicationRx (std::size_t staId, Ptr<const Packet> p)
+{
+  if (p->GetSize () < m_payloadSize)
+    {
+      return;
+    }
+  auto itTxPacket = m_appPacketTxMap.find (p->GetUid ());
+  if (itTxPacket != m_appPacketTxMap.end ())
+    {
+      Time latency = (Simulator::Now () - itTxPacket->second);
+      auto itStaLatencies = m_appLatencyMap.find (staId);
+      NS_ASSERT (itStaLatencies != m_appLatencyMap.end ());
+      itStaLatencies->second.Add (latency);
+      m_appPacketTxMap.erase (itTxPacket);
+    }
+}
+
+std::size_t
+WifiDlOfdmaExample::GetStaIndex (Mac48Address address) const
+{
+  auto it = m_staIndexByAddress.find (AddressToInteger (address));
+  NS_ASSERT (it != m_staIndexByAddress.end ());
+  return it->second;
+}
+
+std::size_t
+WifiDlOfdmaExample::GetStaIndexByAid (uint16_t aid) const
+{
+  NS_ASSERT (aid < m_staIndexByAid.size () && m_staIndexByAid[aid] < m_nStations);
+  return m_staIndexByAid[aid];
+}
+
+void
+WifiDlOfdmaExample::StampApplicationTx (Ptr<const Packet> p)
+{
+  AppTxTimeTag tag;
+  tag.SetTxTime (Simulator::Now ());
+  tag.SetWrite (m_nextWriteId++, p->GetSize ());
+  p->AddByteTag (tag);
+}
+
+void
+WifiDlOfdmaExample::NotifySinkRx (std::size_t staId, Ptr<const Packet> p)
+{
+  auto itStaLatencies = m_appLatencyMap.find (staId);
+  NS_ASSERT (itStaLatencies != m_appLatencyMap.end ());
+
+  // A TCP segment may carry (parts of) the data of multiple application writes,
+  // each of which is stamped with its own tag: take a sample for each write whose
+  // last byte is carried by this segment
+  ByteTagIterator it = p->GetByteTagIterator ();
+  while (it.HasNext ())
+    {
+      ByteTagIterator::Item item = it.Next ();
+      if (item.GetTypeId () != AppTxTimeTag::GetTypeId ())
+        {
+          continue;
+        }
+      AppTxTimeTag tag;
+      item.GetTag (tag);
+      uint32_t bytes = item.GetEnd () - item.GetStart ();
+      if (bytes < tag.GetWriteSize ())
+        {
+          auto write = m_partialWrites.insert (std::make_pair (tag.GetWriteId (), 0)).first;
+          write->second += bytes;
+          if (write->second < tag.GetWriteSize ())
+            {
+              continue;
+            }
+          m_partialWrites.erase (write);
+        }
+      itStaLatencies->second.Add (Simulator::Now () - tag.GetTxTime ());
+    }
+}
+
+/**
+ * \param value a value
+ * \return the textual representation of the given value
+ */
+template <typename T>
+static std::string
+ToString (T value)
+{
+  std::ostringstream oss;
+  oss << std::boolalpha << value;
+  return oss.str ();
+}
+
+void
+WifiDlOfdmaExample::CollectResults (const LatencyHistogram& overallLatency)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_configFields.clear ();
+  m_aggregateResults.clear ();
+  m_staResults.clear ();
+
+  // Configuration (named after the corresponding command line options)
+  m_configFields.push_back (std::make_pair ("payloadSize", ToString (m_payloadSize)));
+  m_configFields.push_back (std::make_pair ("simulationTime", ToString (m_simulationTime)));
+  m_configFields.push_back (std::make_pair ("nStations", ToString (m_nStations)));
+  m_configFields.push_back (std::make_pair ("radius", ToString (m_radius)));
+  m_configFields.push_back (std::make_pair ("enableDlOfdma", ToString (m_enableDlOfdma)));
+  m_configFields.push_back (std::make_pair ("forceDlOfdma", ToString (m_forceDlOfdma)));
+  m_configFields.push_back (std::make_pair ("dlAckType", ToString (m_dlAckSeqType)));
+  m_configFields.push_back (std::make_pair ("enableUlOfdma", ToString (m_enableUlOfdma)));
+  m_configFields.push_back (std::make_pair ("ulPsduSize", ToString (m_ulPsduSize)));
+  m_configFields.push_back (std::make_pair ("channelWidth", ToString (m_channelWidth)));
+  m_configFields.push_back (std::make_pair ("guardInterval", ToString (m_guardInterval)));
+  m_configFields.push_back (std::make_pair ("maxRus", ToString (+m_maxNRus)));
+  m_configFields.push_back (std::make_pair ("ofdmaManager", m_ofdmaManager));
+  m_configFields.push_back (std::make_pair ("delayBudget", ToString (m_delayBudget)));
+  m_configFields.push_back (std::make_pair ("mcs", ToString (m_mcs)));
+  m_configFields.push_back (std::make_pair ("maxAmsduSize", ToString (m_maxAmsduSize)));
+  m_configFields.push_back (std::make_pair ("maxAmpduSize", ToString (m_maxAmpduSize)));
+  m_configFields.push_back (std::make_pair ("txopLimit", ToString (m_txopLimit)));
+  m_configFields.push_back (std::make_pair ("queueSize", ToString (m_macQueueSize)));
+  m_configFields.push_back (std::make_pair ("msduLifetime", ToString (m_msduLifetime)));
+  m_configFields.push_back (std::make_pair ("continueTxop", ToString (m_continueTxop)));
+  m_configFields.push_back (std::make_pair ("baBufferSize", ToString (m_baBufferSize)));
+  m_configFields.push_back (std::make_pair ("dataRate", ToString (m_dataRate)));
+  m_configFields.push_back (std::make_pair ("transport", m_transport));
+  m_configFields.push_back (std::make_pair ("queueDisc", m_queueDisc));
+  m_configFields.push_back (std::make_pair ("cacheLinkGains", ToString (m_cacheLinkGains)));
+  m_configFields.push_back (std::make_pair ("cacheTxDurations", ToString (m_cacheTxDurations)));
+  m_configFields.push_back (std::make_pair ("multiFlowSource", ToString (m_multiFlowSource)));
+  m_configFields.push_back (std::make_pair ("trafficTrace", m_trafficTrace));
+  m_configFields.push_back (std::make_pair ("traceTimeScale", ToString (m_traceTimeScale)));
+  m_configFields.push_back (std::make_pair ("traceLoop", ToString (m_traceLoop)));
+  m_configFields.push_back (std::make_pair ("warmup", ToString (m_warmup)));
+  m_configFields.push_back (std::make_pair ("adaptiveWarmup", ToString (m_adaptiveWarmup)));
+  m_configFields.push_back (std::make_pair ("maxWarmup", ToString (m_maxWarmup)));
+  m_configFields.push_back (std::make_pair ("assocBatchSize", ToString (m_assocBatchSize)));
+  m_configFields.push_back (std::make_pair ("staticArp", ToString (m_staticArp)));
+  m_configFields.push_back (std::make_pair ("latencyMode", m_latencyMode));
+  m_configFields.push_back (std::make_pair ("rngSeed", ToString (RngSeedManager::GetSeed ())));
+  m_configFields.push_back (std::make_pair ("rngRun", ToString (RngSeedManager::GetRun ())));
+
+  // Per-station metrics (the values of each station are listed below in the same order)
+  const char *staFields[] = {"throughputMbps", "failed", "expired", "minAmpduSize", "maxAmpduSize", "nAmpdus",
+                             "minAmpduRatio", "maxAmpduRatio", "avgAmpduRatio",
+                             "minHolDelayMs", "maxHolDelayMs", "avgHolDelayMs",
+                             "latencySamples", "avgLatencyMs", "p50LatencyMs", "p90LatencyMs",
+                             "p99LatencyMs", "p999LatencyMs", "maxLatencyMs",
+                             "nSolicitingTriggerFrames", "nHeTbPpdus",
+                             "minLengthRatio", "maxLengthRatio", "avgLengthRatio",
+                             "airtimeMs", "airtimeShare", "sourceTxPackets", "sourceTxBytes"};
+  const std::size_t nStaFields = sizeof (staFields) / sizeof (staFields[0]);
+  for (std::size_t k = 0; k < nStaFields; k++)
+    {
+      m_staResults.push_back (std::make_pair (staFields[k], std::vector<double> (m_staNodes.GetN ())));
+    }
+
+  double totalTput = 0.0;
+  uint64_t totalFailed = 0;
+  uint64_t totalExpired = 0;
+  uint64_t heTbPpdus = 0;
+  uint64_t solicitingTriggerFrames = 0;
+  double totalStaAirtime = std::accumulate (m_staAirtime.begin (), m_staAirtime.end (), 0.0);
+  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+    {
+      const WifiDlOfdmaStats::DlStats& dl = m_stats.GetDlStats (i);
+      const WifiDlOfdmaStats::UlStats& ul = m_stats.GetUlStats (i);
+      const LatencyHistogram& latency = m_appLatencyMap.at (i);
+      double tput = ((m_rxStop[i] - m_rxStart[i]) * 8.) / (m_simulationTime * 1e6);
+      double values[] = {tput, static_cast<double> (dl.failed), static_cast<double> (dl.expired),
+                         static_cast<double> (dl.minAmpduSize), static_cast<double> (dl.maxAmpduSize),
+                         static_cast<double> (dl.nAmpdus),
+                         dl.ampduRatio.min, dl.ampduRatio.max, dl.ampduRatio.avg,
+                         dl.holDelay.min, dl.holDelay.max, dl.holDelay.avg,
+                         static_cast<double> (latency.GetCount ()), latency.GetMean ().ToDouble (Time::MS),
+                         latency.GetPercentile (50).ToDouble (Time::MS), latency.GetPercentile (90).ToDouble (Time::MS),
+                         latency.GetPercentile (99).ToDouble (Time::MS), latency.GetPercentile (99.9).ToDouble (Time::MS),
+                         latency.GetMax ().ToDouble (Time::MS),
+                         static_cast<double> (ul.nSolicitingTriggerFrames), static_cast<double> (ul.lengthRatio.count),
+                         ul.lengthRatio.min, ul.lengthRatio.max, ul.lengthRatio.avg,
+                         m_staAirtime[i] * 1000, (totalStaAirtime > 0 ? m_staAirtime[i] / totalStaAirtime : 0.0),
+                         static_cast<double> (m_sourceTxPackets[i]), static_cast<double> (m_sourceTxBytes[i])};
+      NS_ASSERT (sizeof (values) / sizeof (values[0]) == nStaFields);
+      for (std::size_t k = 0; k < nStaFields; k++)
+        {
+          m_staResults[k].second[i] = values[k];
+        }
+
+      totalTput += tput;
+      totalFailed += dl.failed;
+      totalExpired += dl.expired;
+      heTbPpdus += ul.lengthRatio.count;
+      solicitingTriggerFrames += ul.nSolicitingTriggerFrames;
+    }
+
+  // Aggregate metrics
+  double missingHeTbPpduRatio = 0.0;
+  if (solicitingTriggerFrames > 0)
+    {
+      missingHeTbPpduRatio = static_cast<double> (solicitingTriggerFrames - heTbPpdus) / solicitingTriggerFrames;
+    }
+  m_aggregateResults.push_back (std::make_pair ("totalThroughputMbps", totalTput));
+  m_aggregateResults.push_back (std::make_pair ("totalFailed", totalFailed));
+  m_aggregateResults.push_back (std::make_pair ("totalExpired", totalExpired));
+  m_aggregateResults.push_back (std::make_pair ("maxTxopMs", m_maxTxop.ToDouble (Time::MS)));
+  m_aggregateResults.push_back (std::make_pair ("minDlMuPpduCompleteness", m_stats.GetDlMuPpduCompleteness ().min));
+  m_aggregateResults.push_back (std::make_pair ("maxDlMuPpduCompleteness", m_stats.GetDlMuPpduCompleteness ().max));
+  m_aggregateResults.push_back (std::make_pair ("avgDlMuPpduCompleteness", m_stats.GetDlMuPpduCompleteness ().avg));
+  m_aggregateResults.push_back (std::make_pair ("minHolDelayMs", m_stats.GetHolDelay ().min));
+  m_aggregateResults.push_back (std::make_pair ("maxHolDelayMs", m_stats.GetHolDelay ().max));
+  m_aggregateResults.push_back (std::make_pair ("avgHolDelayMs", m_stats.GetHolDelay ().avg));
+  m_aggregateResults.push_back (std::make_pair ("latencySamples", overallLatency.GetCount ()));
+  m_aggregateResults.push_back (std::make_pair ("avgLatencyMs", overallLatency.GetMean ().ToDouble (Time::MS)));
+  m_aggregateResults.push_back (std::make_pair ("p50LatencyMs", overallLatency.GetPercentile (50).ToDouble (Time::MS)));
+  m_aggregateResults.push_back (std::make_pair ("p90LatencyMs", overallLatency.GetPercentile (90).ToDouble (Time::MS)));
+  m_aggregateResults.push_back (std::make_pair ("p99LatencyMs", overallLatency.GetPercentile (99).ToDouble (Time::MS)));
+  m_aggregateResults.push_back (std::make_pair ("p999LatencyMs", overallLatency.GetPercentile (99.9).ToDouble (Time::MS)));
+  m_aggregateResults.push_back (std::make_pair ("maxLatencyMs", overallLatency.GetMax ().ToDouble (Time::MS)));
+  m_aggregateResults.push_back (std::make_pair ("basicTriggerFramesSent", m_stats.GetNBasicTriggerFramesSent ()));
+  m_aggregateResults.push_back (std::make_pair ("failedTriggerFrames", m_stats.GetNFailedTriggerFrames ()));
+  m_aggregateResults.push_back (std::make_pair ("missingHeTbPpduRatio", missingHeTbPpduRatio));
+  m_aggregateResults.push_back (std::make_pair ("minHeTbPpduCompleteness", m_stats.GetHeTbPpduCompleteness ().min));
+  m_aggregateResults.push_back (std::make_pair ("maxHeTbPpduCompleteness", m_stats.GetHeTbPpduCompleteness ().max));
+  m_aggregateResults.push_back (std::make_pair ("avgHeTbPpduCompleteness", m_stats.GetHeTbPpduCompleteness ().avg));
+  m_aggregateResults.push_back (std::make_pair ("setupSimTimeS", m_setupDuration.GetSeconds ()));
+  m_aggregateResults.push_back (std::make_pair ("setupWallTimeS", m_setupWallTime));
+  m_aggregateResults.push_back (std::make_pair ("warmupS", m_warmupDuration));
+  m_aggregateResults.push_back (std::make_pair ("mserTruncationS", m_mserTruncation));
+  m_aggregateResults.push_back (std::make_pair ("measurementTimeS", m_simulationTime));
+  m_aggregateResults.push_back (std::make_pair ("converged", m_converged));
+  m_aggregateResults.push_back (std::make_pair ("txDurationCacheHitRatio", m_txDurationCache.GetHitRatio ()));
+  // every run reports the same fields (NaN if not applicable), so that the rows
+  // of the CSV results share the same header
+  const double nan = std::numeric_limits<double>::quiet_NaN ();
+  m_aggregateResults.push_back (std::make_pair ("replayTxPackets", m_replay != 0 ? m_replay->GetTxPackets () : nan));
+  m_aggregateResults.push_back (std::make_pair ("replayDropped", m_replay != 0 ? m_replay->GetNDropped () : nan));
+  m_aggregateResults.push_back (std::make_pair ("replaySkipped", m_replay != 0 ? m_replay->GetNSkipped () : nan));
+  m_aggregateResults.push_back (std::make_pair ("replayLoops", m_replay != 0 ? m_replay->GetNLoops () : nan));
+  for (std::size_t c = 0; c < AIRTIME_N_CATEGORIES; c++)
+    {
+      std::string name = GetAirtimeCategoryName (c);
+      name[0] = std::toupper (name[0]);
+      m_aggregateResults.push_back (std::make_pair ("airtime" + name + "Ms", m_airtime[c] * 1000));
+    }
+  m_aggregateResults.push_back (std::make_pair ("airtimeJainIndex", GetAirtimeFairness ()));
+  static const char *phaseNames[] = {"Config", "Setup", "Association", "Warmup", "Measurement", "Tail", "Reporting"};
+  for (const char *phaseName : phaseNames)
+    {
+      double wallTime = nan;
+      double events = nan;
+      double peakRssKb = nan;
+      for (auto& phase : m_profiler.GetPhases ())
+        {
+          if (phase.name == phaseName)
+            {
+              wallTime = phase.wallTime;
+              events = phase.events;
+              peakRssKb = phase.peakRssKb;
+            }
+        }
+      std::string name (phaseName);
+      name[0] = std::tolower (name[0]);
+      m_aggregateResults.push_back (std::make_pair (name + "WallTimeS", wallTime));
+      m_aggregateResults.push_back (std::make_pair (name + "Events", events));
+      m_aggregateResults.push_back (std::make_pair (name + "PeakRssKb", peakRssKb));
+    }
+}
+
+/**
+ * \param os the output stream
+ * \param value the value to write
+ *
+ * Write the given value as a JSON number (NaN and infinite values become null).
+ */
+static void
+WriteJsonNumber (std::ostream& os, double value)
+{
+  if (std::isfinite (value))
+    {
+      os << value;
+    }
+  else
+    {
+      os << "null";
+    }
+}
+
+/**
+ * \param value a string
+ * \return whether the given string is a JSON number
+ */
+static bool
+IsJsonNumber (const std::string& value)
+{
+  char *end;
+  std::strtod (value.c_str (), &end);
+  return !value.empty () && *end == '\0' && std::isdigit (value.back ()) && value[0] != '+';
+}
+
+/**
+ * \param value a string
+ * \return the given string, quoted as a JSON string
+ */
+static std::string
+Quote (const std::string& value)
+{
+  std::string quoted = "\"";
+  for (char c : value)
+    {
+      if (c == '"' || c == '\\')
+        {
+          quoted += '\\';
+        }
+      quoted += c;
+    }
+  return quoted + "\"";
+}
+
+/**
+ * \param value a string
+ * \return the given string, quoted as a CSV field (RFC 4180)
+ */
+static std::string
+CsvQuote (const std::string& value)
+{
+  std::string quoted = "\"";
+  for (char c : value)
+    {
+      if (c == '"')
+        {
+          quoted += '"';
+        }
+      quoted += c;
+    }
+  return quoted + "\"";
+}
+
+/**
+ * Append a record to the given file. The file is locked while the record is
+ * appended, so that concurrent runs (e.g., sweep workers) can share the same file.
+ * If a header is given, it is written before the record if the file is empty and
+ * must match the first line of the file otherwise.
+ *
+ * \param fileName the name of the file
+ * \param header the line to write before the record if the file is empty
+ * \param record the record to append
+ */
+static void
+AppendRecord (const std::string& fileName, const std::string& header, const std::string& record)
+{
+  int fd = open (fileName.c_str (), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  NS_ABORT_MSG_IF (fd < 0, "Cannot open " << fileName << ": " << std::strerror (errno));
+  flock (fd, LOCK_EX);
+
+  struct stat st;
+  std::string data = record;
+  if (!header.empty () && fstat (fd, &st) == 0 && st.st_size == 0)
+    {
+      data = header + data;
+    }
+  else if (!header.empty ())
+    {
+      std::ifstream file (fileName);
+      std::string firstLine;
+      std::getline (file, firstLine);
+      NS_ABORT_MSG_IF (firstLine + "\n" != header,
+                       "The columns of " << fileName << " do not match those of this run; "
+                       "use a new results file");
+    }
+  const char *buffer = data.c_str ();
+  std::size_t left = data.size ();
+  while (left > 0)
+    {
+      ssize_t written = write (fd, buffer, left);
+      if (written < 0 && errno == EINTR)
+        {
+          continue;
+        }
+      NS_ABORT_MSG_IF (written < 0, "Cannot write to " << fileName << ": " << std::strerror (errno));
+      buffer += written;
+      left -= written;
+    }
+
+  flock (fd, LOCK_UN);
+  close (fd);
+}
+
+void
+WifiDlOfdmaExample::WriteJsonResults (const std::string& fileName) const
+{
+  NS_LOG_FUNCTION (this << fileName);
+
+  // one JSON object per line (JSON Lines), per-station metrics are stored by column
+  std::ostringstream json;
+  json << std::setprecision (10) << "{\"config\":{";
+  for (std::size_t i = 0; i < m_configFields.size (); i++)
+    {
+      const std::string& value = m_configFields[i].second;
+      json << (i > 0 ? "," : "") << Quote (m_configFields[i].first) << ":"
+           << (IsJsonNumber (value) || value == "true" || value == "false" ? value : Quote (value));
+    }
+  json << "},\"aggregate\":{";
+  for (std::size_t i = 0; i < m_aggregateResults.size (); i++)
+    {
+      json << (i > 0 ? "," : "") << Quote (m_aggregateResults[i].first) << ":";
+      WriteJsonNumber (json, m_aggregateResults[i].second);
+    }
+  json << "},\"stations\":{";
+  for (std::size_t i = 0; i < m_staResults.size (); i++)
+    {
+      json << (i > 0 ? "," : "") << Quote (m_staResults[i].first) << ":[";
+      for (std::size_t j = 0; j < m_staResults[i].second.size (); j++)
+        {
+          json << (j > 0 ? "," : "");
+          WriteJsonNumber (json, m_staResults[i].second[j]);
+        }
+      json << "]";
+    }
+  json << "}}" << std::endl;
+
+  AppendRecord (fileName, "", json.str ());
+}
+
+void
+WifiDlOfdmaExample::WriteCsvResults (const std::string& fileName) const
+{
+  NS_LOG_FUNCTION (this << fileName);
 
-  Simulator::Stop (Seconds (m_warmup + m_simulationTime + 100));
+  // one row per run, per-station metrics are semicolon separated lists
+  std::ostringstream header;
+  std::ostringstream row;
+  row << std::setprecision (10);
+  for (auto& field : m_configFields)
+    {
+      header << field.first << ",";
+      row << (IsJsonNumber (field.second) ? field.second : CsvQuote (field.second)) << ",";
+    }
+  for (auto& result : m_aggregateResults)
+    {
+      header << result.first << ",";
+      row << result.second << ",";
+    }
+  for (std::size_t i = 0; i < m_staResults.size (); i++)
+    {
+      header << (i > 0 ? "," : "") << "sta_" << m_staResults[i].first;
+      row << (i > 0 ? "," : "");
+      for (std::size_t j = 0; j < m_staResults[i].second.size (); j++)
+        {
+          row << (j > 0 ? ";" : "") << m_staResults[i].second[j];
+        }
+    }
+  header << std::endl;
+  row << std::endl;
 
-  //Using NetAnim 
-  // AnimationInterface anim("wifi-dl-ofdma.xml");
-  // uint32_t k=0;
-  // for(uint32_t i=0;i<6;i++){
-  //   for(uint32_t j=0;j<5;j++){
-  //   anim.SetConstantPosition(m_staNodes.Get(k++),i*2,j*2);
-  //   }
-  // }
+  AppendRecord (fileName, header.str (), row.str ());
+}
 
-  //anim.SetConstantPosition(m_apNodes.Get(0),40.0,40.0);
-  
-  
-  Simulator::Run ();
+std::string
+WifiDlOfdmaExample::GetSweepFile (void) const
+{
+  return m_sweepFile;
+}
 
-  //Adding for flow monitor
-  flowMonitor->SerializeToXmlFile("FLOWMON_30STA_50SEC_05-05-11:55.xml", true, true);
+uint32_t
+WifiDlOfdmaExample::GetSweepJobs (void) const
+{
+  return m_sweepJobs;
+}
+
+std::string
+WifiDlOfdmaExample::GetSweepOutput (void) const
+{
+  return m_sweepOutput;
+}
+
+std::string
+WifiDlOfdmaExample::GetSummaryHeader (void)
+{
+  return "totalThroughput,totalFailed,totalExpired,maxTxopMs,avgHolDelayMs,avgDlMuPpduCompleteness,"
+         "avgLatencyMs,p99LatencyMs,setupSimTimeS,setupWallTimeS,runWallTimeS,eventsPerS,peakRssKb,staThroughput";
+}
+
+std::string
+WifiDlOfdmaExample::GetSummary (void) const
+{
+  return m_summary;
+}
+
+std::string
+WifiDlOfdmaExample::GetReadTrace (void) const
+{
+  return m_readTrace;
+}
+
+std::string
+WifiDlOfdmaExample::GetBenchmark (void) const
+{
+  return m_benchmark;
+}
+
+std::string
+WifiDlOfdmaExample::GetBenchmarkGrid (void) const
+{
+  return m_benchmarkGrid;
+}
+
+bool
+WifiDlOfdmaExample::GetBenchmarkFullGrid (void) const
+{
+  return m_benchmarkFullGrid;
+}
+
+double
+WifiDlOfdmaExample::GetBenchmarkThreshold (void) const
+{
+  return m_benchmarkThreshold;
+}
+
+double
+WifiDlOfdmaExample::GetBenchmarkEventsThreshold (void) const
+{
+  return m_benchmarkEventsThreshold;
+}
+
+double
+WifiDlOfdmaExample::GetBenchmarkRssThreshold (void) const
+{
+  return m_benchmarkRssThreshold;
+}
+
+double
+WifiDlOfdmaExample::GetBenchmarkThroughputThreshold (void) const
+{
+  return m_benchmarkThroughputThreshold;
+}
+
+bool
+WifiDlOfdmaExample::GetBenchmarkUpdate (void) const
+{
+  return m_benchmarkUpdate;
+}
+
+uint32_t
+WifiDlOfdmaExample::GetBenchmarkJobs (void) const
+{
+  return m_benchmarkJobs;
+}
+
+std::string
+WifiDlOfdmaExample::GetBenchmarkOutput (void) const
+{
+  return m_benchmarkOutput;
+}
+
+uint32_t
+WifiDlOfdmaExample::GetReplications (void) const
+{
+  return m_replications;
+}
+
+uint32_t
+WifiDlOfdmaExample::GetMinReplications (void) const
+{
+  return m_minReplications;
+}
+
+double
+WifiDlOfdmaExample::GetReplicationPrecision (void) const
+{
+  return m_replicationPrecision;
+}
+
+uint32_t
+WifiDlOfdmaExample::GetReplicationJobs (void) const
+{
+  return m_replicationJobs;
+}
+
+std::string
+WifiDlOfdmaExample::GetReplicationOutput (void) const
+{
+  return m_replicationOutput;
+}
+
+std::string
+WifiDlOfdmaExample::GetScenarios (void) const
+{
+  return m_scenarios;
+}
+
+std::string
+WifiDlOfdmaExample::GetScenarioOutput (void) const
+{
+  return m_scenarioOutput;
+}
+
+std::size_t
+WifiDlOfdmaExample::GetNVariants (void) const
+{
+  return m_variantList.size ();
+}
+
+const std::vector<std::pair<std::string, double> >&
+WifiDlOfdmaExample::GetAggregateResults (void) const
+{
+  return m_aggregateResults;
+}
+
+const std::vector<std::pair<std::string, std::vector<double> > >&
+WifiDlOfdmaExample::GetStaResults (void) const
+{
+  return m_staResults;
+}
+
+/**
+ * \brief Configuration of a WifiDlOfdmaScenario run
+ *
+ * Options are given by name, exactly as on the command line of the example (e.g.,
+ * "nStations" and "20"). Options given later override those given earlier and
+ * options not given keep their default value. Names and values cannot contain
+ * spaces or '='.
+ */
+struct WifiDlOfdmaScenarioConfig
+{
+  /**
+   * Set the value of an option.
+   *
+   * \tparam T the type of the value
+   * \param name the name of the option
+   * \param value the value of the option
+   */
+  template <typename T>
+  void Set (const std::string& name, const T& value)
+  {
+    std::ostringstream oss;
+    oss << std::setprecision (17) << value;
+    options.push_back (std::make_pair (name, oss.str ()));
+  }
+
+  std::vector<std::pair<std::string, std::string> > options;  ///< (name, value) of the options
+  bool quiet = true;        ///< discard the output of the run (rather than writing it to the stream of the runner)
+};
+
+/**
+ * \brief Results of a WifiDlOfdmaScenario run
+ */
+struct WifiDlOfdmaScenarioResults
+{
+  /**
+   * \param name the name of an aggregate result
+   * \return the value of the given aggregate result (NaN if there is no such result)
+   */
+  double Get (const std::string& name) const
+  {
+    for (auto& result : aggregateResults)
+      {
+        if (result.first == name)
+          {
+            return result.second;
+          }
+      }
+    return std::numeric_limits<double>::quiet_NaN ();
+  }
+
+  std::vector<std::pair<std::string, double> > aggregateResults;             ///< aggregate results
+  std::vector<std::pair<std::string, std::vector<double> > > staResults;     ///< per-station results
+  std::string summary;      ///< comma separated summary (see WifiDlOfdmaExample::GetSummaryHeader)
+  double wallTime = 0.0;    ///< wall clock time of the run (seconds)
+};
+
+/**
+ * \brief Run WifiDlOfdmaExample scenarios in the calling process
+ *
+ * Each call to Run configures, sets up and runs a new instance of the example and
+ * then restores the global state of the simulator: the simulator and the node and
+ * channel lists are destroyed, the attribute defaults and the global values (e.g.,
+ * those set by the example through Config::SetDefault) are reset and the stream
+ * index counter of the random number generators is reset, so that every run gives
+ * the same results as a run in a new process with the same options. Hence, a driver
+ * can run many (short) configurations without paying for process start, library
+ * loading and TypeId registration every time.
+ *
+ * Runs that fork (sweeps, benchmarks, replications and variants) or do not simulate
+ * (reading a trace) cannot be run this way. Errors still abort the process.
+ *
+ * \code
+ *   WifiDlOfdmaScenario scenario;
+ *   WifiDlOfdmaScenarioConfig config;
+ *   config.Set ("nStations", 8);
+ *   config.Set ("simulationTime", 1.0);
+ *   double tput = scenario.Run (config).Get ("totalThroughputMbps");
+ * \endcode
+ *
+ * Scenarios can also be listed in a file (one scenario per line, as a list of
+ * name=value tokens) and run with:
+ *
+ * ./waf --run "wifi-dl-ofdma --scenarios=scenarios.txt --scenarioOutput=results.csv [options]"
+ */
+class WifiDlOfdmaScenario
+{
+public:
+  /**
+   * Create a scenario runner.
+   *
+   * \param os the stream the output of the (non quiet) runs and the progress are written to
+   */
+  WifiDlOfdmaScenario (std::ostream& os = std::cout);
+  /**
+   * Run a scenario.
+   *
+   * \param config the configuration of the scenario
+   * \return the results of the scenario
+   */
+  WifiDlOfdmaScenarioResults Run (const WifiDlOfdmaScenarioConfig& config);
+  /**
+   * Run the scenarios listed in the given file and append their summaries to the
+   * given CSV file.
+   *
+   * \param scenarioFile the file listing the scenarios
+   * \param outputFile the CSV file the summaries are appended to
+   * \param argc the number of options of the invocation (applied to all the scenarios)
+   * \param argv the options of the invocation
+   * \return the number of scenarios run
+   */
+  uint32_t RunFile (const std::string& scenarioFile, const std::string& outputFile, int argc, char *argv[]);
+  /**
+   * \return the number of scenarios run so far
+   */
+  uint32_t GetNRuns (void) const;
+
+private:
+  /**
+   * Restore the global state of the simulator.
+   */
+  static void Reset (void);
+
+  std::ostream *m_os;  // stream the output of the runs is written to
+  uint32_t m_nRuns;    // number of scenarios run so far
+};
+
+WifiDlOfdmaScenario::WifiDlOfdmaScenario (std::ostream& os)
+  : m_os (&os),
+    m_nRuns (0)
+{
+}
+
+void
+WifiDlOfdmaScenario::Reset (void)
+{
+  // destroying the simulator disposes of the nodes and the channels and clears the
+  // node and channel lists
+  Simulator::Destroy ();
+  Config::Reset ();
+  RngSeedManager::ResetNextStreamIndex ();
+  NS_ABORT_MSG_IF (NodeList::GetNNodes () != 0 || ChannelList::GetNChannels () != 0,
+                   "Nodes or channels survived the destruction of the simulator");
+  // checking the lists above creates them again, along with a simulator
+  Simulator::Destroy ();
+}
+
+WifiDlOfdmaScenarioResults
+WifiDlOfdmaScenario::Run (const WifiDlOfdmaScenarioConfig& config)
+{
+  auto start = std::chrono::steady_clock::now ();
+  Reset ();
+
+  std::vector<std::string> args (1, "wifi-dl-ofdma");
+  for (auto& option : config.options)
+    {
+      NS_ABORT_MSG_IF (option.first.empty () || option.first.find_first_of (" =") != std::string::npos
+                       || option.second.find_first_of (" =") != std::string::npos,
+                       "Invalid option \"" << option.first << "\" = \"" << option.second
+                       << "\" (names and values cannot contain spaces or '=')");
+      args.push_back ("--" + option.first + "=" + option.second);
+    }
+  std::vector<char *> argv;
+  for (auto& arg : args)
+    {
+      argv.push_back (&arg[0]);
+    }
+  argv.push_back (nullptr);
+
+  // a stream without buffer discards the output of quiet runs
+  std::ostream null (nullptr);
+
+  WifiDlOfdmaScenarioResults results;
+  {
+    // the example is destroyed, and its references to nodes and devices released,
+    // before the global state is reset
+    WifiDlOfdmaExample example;
+    example.SetOutputStream (config.quiet ? null : *m_os);
+    example.Config (args.size (), argv.data ());
+    NS_ABORT_MSG_IF (!example.GetSweepFile ().empty () || !example.GetBenchmark ().empty ()
+                     || example.GetReplications () > 0 || !example.GetReadTrace ().empty ()
+                     || !example.GetScenarios ().empty () || example.GetNVariants () > 0,
+                     "Sweeps, benchmarks, replications, variants, trace reading and scenario files "
+                     "cannot be run as in-process scenarios");
+    example.Setup ();
+    example.Run ();
+    results.aggregateResults = example.GetAggregateResults ();
+    results.staResults = example.GetStaResults ();
+    results.summary = example.GetSummary ();
+  }
+
+  m_os->flush ();
+  Reset ();
+  m_nRuns++;
+  results.wallTime = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+  return results;
+}
+
+uint32_t
+WifiDlOfdmaScenario::RunFile (const std::string& scenarioFile, const std::string& outputFile, int argc, char *argv[])
+{
+  std::ifstream file (scenarioFile);
+  NS_ABORT_MSG_IF (!file.is_open (), "Cannot open scenario file " << scenarioFile);
+  std::ifstream existing (outputFile);
+  bool header = !existing.good () || existing.peek () == std::ifstream::traits_type::eof ();
+  existing.close ();
+  std::ofstream table (outputFile, std::ios::app);
+  NS_ABORT_MSG_IF (!table.is_open (), "Cannot open results table " << outputFile);
+  if (header)
+    {
+      table << "scenario,wallTimeS," << WifiDlOfdmaExample::GetSummaryHeader () << std::endl;
+    }
+
+  // scenarios are passed the options of the invocation, except the scenario file itself
+  WifiDlOfdmaScenarioConfig base;
+  for (int i = 1; i < argc; i++)
+    {
+      std::string arg (argv[i]);
+      NS_ABORT_MSG_IF (arg.compare (0, 2, "--") != 0 || arg.size () == 2,
+                       "Invalid option (expected --name=value or --name): " << arg);
+      std::size_t pos = arg.find ('=');
+      if (pos == std::string::npos)
+        {
+          // boolean options can be given without value, which sets them
+          base.options.push_back (std::make_pair (arg.substr (2), "true"));
+          continue;
+        }
+      base.options.push_back (std::make_pair (arg.substr (2, pos - 2), arg.substr (pos + 1)));
+    }
+  base.Set ("scenarios", "");
+
+  std::string line;
+  uint32_t nRun = 0;
+  while (std::getline (file, line))
+    {
+      std::istringstream iss (line);
+      std::string token;
+      WifiDlOfdmaScenarioConfig config (base);
+      std::string key;
+
+      while (iss >> token && token[0] != '#')
+        {
+          std::size_t pos = token.find ('=');
+          NS_ABORT_MSG_IF (pos == std::string::npos || pos == 0,
+                           "Invalid token in scenario file: " << token << " (expected name=value)");
+          config.options.push_back (std::make_pair (token.substr (0, pos), token.substr (pos + 1)));
+          key += (key.empty () ? "" : " ") + token;
+        }
+      if (key.empty ())
+        {
+          continue;
+        }
+
+      WifiDlOfdmaScenarioResults results = Run (config);
+      table << "\"" << key << "\"," << results.wallTime << "," << results.summary << std::endl;
+      nRun++;
+      *m_os << "Completed [" << key << "] in " << results.wallTime << " s" << std::endl;
+    }
+
+  *m_os << std::endl << "Completed scenarios = " << nRun << std::endl;
+  return nRun;
+}
+
+uint32_t
+WifiDlOfdmaScenario::GetNRuns (void) const
+{
+  return m_nRuns;
+}
+
+
+
+/**
+ * Run WifiDlOfdmaExample with the given options in a worker process.
+ *
+ * \param example the example to configure, set up and run
+ * \param args the options of the run (options given later override those given earlier)
+ * \param filePrefix the prefix of the per-run output files of the worker
+ */
+static void
+RunExampleWorker (WifiDlOfdmaExample& example, std::vector<std::string> args, const std::string& filePrefix)
+{
+  std::vector<char *> workerArgv;
+  for (auto& arg : args)
+    {
+      workerArgv.push_back (&arg[0]);
+    }
+  workerArgv.push_back (nullptr);
+
+  example.Config (args.size (), workerArgv.data ());
+  // concurrent workers must not share the flow monitor file and the binary trace
+  example.RenameOutputFiles (filePrefix);
+  example.Setup ();
+  example.Run ();
+}
+
+/**
+ * \brief Run a parameter sweep of WifiDlOfdmaExample on a pool of worker processes
+ *
+ * The sweep file lists one parameter grid per line, e.g.:
+ *
+ * # comment
+ * nStations=10,20,40 mcs=0,5 dlAckType=1,2,3
+ * nStations=100 transport=Tcp
+ *
+ * Every line is expanded into the cartesian product of the listed values. Given that
+ * the Simulator is a process-wide singleton, each point is run by a forked worker
+ * process, which is passed the options of the sweep invocation followed by the
+ * options of the point. At most a given number of workers run at the same time and
+ * the next pending point is handed to a new worker as soon as a worker terminates.
+ *
+ * The summary of every completed point is appended to the results.csv table in the
+ * output directory, which also contains the log of each point. Points already in
+ * the table are skipped, hence an interrupted sweep is resumed by running it again.
+ */
+class WifiDlOfdmaSweep
+{
+public:
+  /**
+   * Create a sweep.
+   *
+   * \param sweepFile the file listing the parameter grids
+   * \param nJobs the maximum number of concurrent workers (0 means one per core)
+   * \param outputDir the directory storing the results table and the logs
+   */
+  WifiDlOfdmaSweep (std::string sweepFile, uint32_t nJobs, std::string outputDir);
+  /**
+   * Run all the points that are not in the results table yet.
+   *
+   * \param argc the number of options of the sweep invocation
+   * \param argv the options of the sweep invocation
+   * \return the number of points that failed
+   */
+  int Run (int argc, char *argv[]);
+
+private:
+  /// A sweep point, i.e., a list of (option, value) pairs
+  typedef std::vector<std::pair<std::string, std::string> > Point;
+
+  /**
+   * Expand the parameter grids listed in the sweep file into sweep points.
+   */
+  void ReadSweepFile (void);
+  /**
+   * Read the keys of the points already in the results table.
+   *
+   * \param table the name of the results table
+   * \return true if the results table already exists and is not empty
+   */
+  bool ReadResultsTable (const std::string& table);
+  /**
+   * Start a worker of the given pool to run the given point.
+   *
+   * \param pool the pool of workers
+   * \param index the index of the point
+   * \param baseArgs the options of the sweep invocation
+   */
+  void StartPoint (WorkerPool& pool, std::size_t index, const std::vector<std::string>& baseArgs);
+  /**
+   * \param point a sweep point
+   * \return the key identifying the given point in the results table
+   */
+  static std::string GetKey (const Point& point);
+  /**
+   * \param index the index of a point
+   * \param extension the extension of the file
+   * \return the name of the file in the output directory associated with the point
+   */
+  std::string GetFileName (std::size_t index, std::string extension) const;
+
+  std::string m_sweepFile;      // file listing the parameter grids
+  uint32_t m_nJobs;             // maximum number of concurrent workers (0 means one per core)
+  std::string m_outputDir;      // directory storing results table and logs
+  std::vector<Point> m_points;  // sweep points
+  std::set<std::string> m_done; // keys of the points already in the results table
+};
+
+WifiDlOfdmaSweep::WifiDlOfdmaSweep (std::string sweepFile, uint32_t nJobs, std::string outputDir)
+  : m_sweepFile (sweepFile),
+    m_nJobs (nJobs),
+    m_outputDir (outputDir)
+{
+}
+
+void
+WifiDlOfdmaSweep::ReadSweepFile (void)
+{
+  std::ifstream file (m_sweepFile);
+  NS_ABORT_MSG_IF (!file.is_open (), "Cannot open sweep file " << m_sweepFile);
+
+  std::string line;
+  while (std::getline (file, line))
+    {
+      std::istringstream iss (line);
+      std::string token;
+      std::vector<Point> grid (1);
+
+      while (iss >> token && token[0] != '#')
+        {
+          std::size_t pos = token.find ('=');
+          NS_ABORT_MSG_IF (pos == std::string::npos || pos == 0,
+                           "Invalid token in sweep file: " << token << " (expected name=v1,v2,...)");
+          std::string name = token.substr (0, pos);
+          std::vector<std::string> values;
+          std::istringstream valueList (token.substr (pos + 1));
+          std::string value;
+          while (std::getline (valueList, value, ','))
+            {
+              values.push_back (value);
+            }
+          NS_ABORT_MSG_IF (values.empty (), "No value given for " << name << " in sweep file");
+
+          // cartesian product of the points expanded so far with the values of this option
+          std::vector<Point> expanded;
+          for (auto& point : grid)
+            {
+              for (auto& v : values)
+                {
+                  expanded.push_back (point);
+                  expanded.back ().push_back (std::make_pair (name, v));
+                }
+            }
+          grid.swap (expanded);
+        }
 
-  double totalTput = 0.0;
-  double tput;
-  std::cout << "Throughput (Mbps)" << std::endl
-            << "-----------------" << std::endl;
-  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
-    {
-      tput = ((m_rxStop[i] - m_rxStart[i]) * 8.) / (m_simulationTime * 1e6);
-      totalTput += tput;
-      std::cout << "STA_" << i << ": " << tput << " ";
+      if (!grid.front ().empty ())
+        {
+          m_points.insert (m_points.end (), grid.begin (), grid.end ());
+        }
     }
-  std::cout << std::endl << std::endl << "Total throughput: " << totalTput << std::endl;
+}
 
-  uint64_t totalFailed = 0;
-  uint64_t failed;
-  std::cout << std::endl << "TX failures" << std::endl
-                         << "-----------" << std::endl;
-  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+bool
+WifiDlOfdmaSweep::ReadResultsTable (const std::string& table)
+{
+  std::ifstream file (table);
+  std::string line;
+
+  if (!std::getline (file, line))
     {
-      auto it = m_dlStats.find (DynamicCast<WifiNetDevice> (m_staDevices.Get (i))->GetMac ()->GetAddress ());
-      NS_ASSERT (it != m_dlStats.end ());
-      failed = it->second.failed;
-      totalFailed += failed;
-      std::cout << "STA_" << i << ": " << failed << " ";
+      return false;
     }
-  std::cout << std::endl << std::endl << "Total failed: " << totalFailed << std::endl;
-
-  uint64_t totalExpired = 0;
-  uint64_t expired;
-  std::cout << std::endl << "Expired MSDUs" << std::endl
-                         << "-------------" << std::endl;
-  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+  // the first line is the header, the key is the first (quoted) field of the other lines
+  while (std::getline (file, line))
     {
-      auto it = m_dlStats.find (DynamicCast<WifiNetDevice> (m_staDevices.Get (i))->GetMac ()->GetAddress ());
-      NS_ASSERT (it != m_dlStats.end ());
-      expired = it->second.expired;
-      totalExpired += expired;
-      std::cout << "STA_" << i << ": " << expired << " ";
+      std::size_t end = line.find ('"', 1);
+      if (line.size () > 0 && line[0] == '"' && end != std::string::npos)
+        {
+          m_done.insert (line.substr (1, end - 1));
+        }
     }
-  std::cout << std::endl << std::endl << "Total expired: " << totalExpired << std::endl;
+  return true;
+}
 
-  std::cout << std::endl << "(Min,Max,Count) A-MPDU size" << std::endl
-                         << "---------------------------" << std::endl;
-  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+std::string
+WifiDlOfdmaSweep::GetKey (const Point& point)
+{
+  std::string key;
+  for (auto& param : point)
     {
-      auto it = m_dlStats.find (DynamicCast<WifiNetDevice> (m_staDevices.Get (i))->GetMac ()->GetAddress ());
-      NS_ASSERT (it != m_dlStats.end ());
-      std::cout << "STA_" << i << ": (" << it->second.minAmpduSize << "," << it->second.maxAmpduSize
-                               << "," << it->second.nAmpdus << ") ";
+      key += (key.empty () ? "" : " ") + param.first + "=" + param.second;
     }
+  return key;
+}
 
-  std::cout << std::endl << std::endl << "Maximum TXOP duration: " << m_maxTxop.ToDouble (Time::MS) << "ms" << std::endl;
+std::string
+WifiDlOfdmaSweep::GetFileName (std::size_t index, std::string extension) const
+{
+  std::ostringstream oss;
+  oss << m_outputDir << "/point-" << std::setfill ('0') << std::setw (5) << index << extension;
+  return oss.str ();
+}
 
-  std::cout << std::endl << "(Min,Max,Avg) A-MPDU size to max A-MPDU size in DL MU PPDU ratio" << std::endl
-                         << "----------------------------------------------------------------" << std::endl;
-  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+void
+WifiDlOfdmaSweep::StartPoint (WorkerPool& pool, std::size_t index, const std::vector<std::string>& baseArgs)
+{
+  if (!pool.Spawn (index, GetFileName (index, ".log")))
     {
-      auto it = m_dlStats.find (DynamicCast<WifiNetDevice> (m_staDevices.Get (i))->GetMac ()->GetAddress ());
-      NS_ASSERT (it != m_dlStats.end ());
-      std::cout << std::fixed << std::setprecision (3)
-                << "STA_" << i << ": (" << it->second.minAmpduRatio << ", " << it->second.maxAmpduRatio
-                               << ", " << it->second.avgAmpduRatio << ") ";
+      return;
     }
 
-  std::cout << std::endl << std::endl << "DL MU PPDU completeness: ("
-                                      << m_minAmpduRatio << ", "
-                                      << m_maxAmpduRatio << ", "
-                                      << m_avgAmpduRatio << ")" << std::endl;
-
-  std::cout << std::endl << "(Min,Max,Avg) Pairwise head-of-line delay (ms)" << std::endl
-                         << "----------------------------------------------" << std::endl;
-  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+  // Worker process: the options of the point override those of the sweep invocation
+  std::vector<std::string> args (baseArgs);
+  for (auto& param : m_points[index])
     {
-      auto it = m_dlStats.find (DynamicCast<WifiNetDevice> (m_staDevices.Get (i))->GetMac ()->GetAddress ());
-      NS_ASSERT (it != m_dlStats.end ());
-      std::cout << std::fixed << std::setprecision (3)
-                << "STA_" << i << ": (" << it->second.minHolDelay << ", " << it->second.maxHolDelay
-                               << ", " << it->second.avgHolDelay << ") ";
+      args.push_back ("--" + param.first + "=" + param.second);
     }
+  WifiDlOfdmaExample example;
+  RunExampleWorker (example, args, GetFileName (index, ""));
 
-  std::cout << std::endl << std::endl << "Head-of-line delay (ms): ("
-                                      << m_minHolDelay << ", "
-                                      << m_maxHolDelay << ", "
-                                      << m_avgHolDelay << ")" << std::endl;
+  std::ofstream row (GetFileName (index, ".row"));
+  row << example.GetSummary () << std::endl;
+  row.close ();
+  WorkerPool::Exit (!row.fail ());
+}
 
-  std::cout << std::endl << "Average latency (ms)" << std::endl
-                         << "--------------------" << std::endl;
+int
+WifiDlOfdmaSweep::Run (int argc, char *argv[])
+{
+  ReadSweepFile ();
 
-  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+  NS_ABORT_MSG_IF (mkdir (m_outputDir.c_str (), 0755) != 0 && errno != EEXIST,
+                   "Cannot create directory " << m_outputDir << ": " << std::strerror (errno));
+  std::string tableName = m_outputDir + "/results.csv";
+  bool resume = ReadResultsTable (tableName);
+  std::ofstream table (tableName, std::ios::app);
+  NS_ABORT_MSG_IF (!table.is_open (), "Cannot open results table " << tableName);
+  if (!resume)
     {
-      auto it = m_appLatencyMap.find (i);
-      NS_ASSERT (it != m_appLatencyMap.end ());
-      double average_latency_ms = (std::accumulate (it->second.begin (), it->second.end (), NanoSeconds (0))).ToDouble (Time::MS) / it->second.size ();
-      std::cout << "STA_" << i << ": " << average_latency_ms << " ";
+      table << "point," << WifiDlOfdmaExample::GetSummaryHeader () << std::endl;
     }
 
-  std::cout << std::endl << std::endl << "Unresponded TFs ratio/(Min,Max,Avg) HE TB PPDU duration to UL Length ratio"
-                         << std::endl << "--------------------------------------------------------------------------"
-                         << std::endl;
-  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+  // workers are passed the options of the sweep invocation, except the sweep itself
+  std::vector<std::string> baseArgs (argv, argv + argc);
+  baseArgs.push_back ("--sweep=");
+  WorkerPool pool (m_nJobs);
+
+  std::cout << "Sweep points = " << m_points.size () << std::endl
+            << "Already completed = " << m_done.size () << std::endl
+            << "Workers = " << pool.GetNJobs () << std::endl << std::endl;
+
+  std::size_t next = 0;
+  std::size_t nCompleted = 0;
+  int nFailed = 0;
+
+  while (true)
     {
-      std::cout<<"i="<<i<<"\n";
-      if(i%2==0)
-        continue;
-      auto it = m_ulStats.find (DynamicCast<WifiNetDevice> (m_staDevices.Get (i))->GetMac ()->GetAddress ());
-      NS_ASSERT (it != m_ulStats.end ());
-      double unrespondedTfRatio = 0.0;
-      if (it->second.nSolicitingTriggerFrames > 0)
+      while (next < m_points.size () && m_done.find (GetKey (m_points[next])) != m_done.end ())
         {
-          unrespondedTfRatio = static_cast<double> (it->second.nSolicitingTriggerFrames - it->second.nLengthRatioSamples)
-                               / it->second.nSolicitingTriggerFrames;
+          next++;
+        }
+      if (next < m_points.size () && pool.CanSpawn ())
+        {
+          StartPoint (pool, next, baseArgs);
+          next++;
+          continue;
+        }
+      if (pool.IsIdle ())
+        {
+          break;
         }
 
-      std::cout << std::fixed << std::setprecision (3)
-                << "STA_" << i << ": " << unrespondedTfRatio << "/(" << it->second.minLengthRatio
-                               << ", " << it->second.maxLenghtRatio
-                               << ", " << it->second.avgLengthRatio << ") ";
-    }
-
-  std::cout << std::endl << std::endl << "(Failed, Sent) Basic Trigger Frames: ("
-                                      << m_nFailedTriggerFrames << ", "
-                                      << m_nBasicTriggerFramesSent << ")" << std::endl;
+      std::size_t index;
+      bool success = pool.Reap (index);
 
-  uint64_t heTbPPduTotalCount = 0;
-  uint64_t solicitingTriggerFrames = 0;
-  for (auto& ulStaStats : m_ulStats)
-    {
-      heTbPPduTotalCount += ulStaStats.second.nLengthRatioSamples;
-      solicitingTriggerFrames += ulStaStats.second.nSolicitingTriggerFrames;
-    }
-  double missingHeTbPpduRatio = 0.0;
-  if (solicitingTriggerFrames > 0)
-    {
-      missingHeTbPpduRatio = static_cast<double> (solicitingTriggerFrames - heTbPPduTotalCount)
-                             / solicitingTriggerFrames;
+      std::string key = GetKey (m_points[index]);
+      std::string rowName = GetFileName (index, ".row");
+      std::ifstream row (rowName);
+      std::string summary;
+      if (success && std::getline (row, summary))
+        {
+          table << "\"" << key << "\"," << summary << std::endl;
+          m_done.insert (key);
+          nCompleted++;
+          std::cout << "Completed [" << key << "]" << std::endl;
+        }
+      else
+        {
+          nFailed++;
+          std::cout << "FAILED [" << key << "], see " << GetFileName (index, ".log") << std::endl;
+        }
+      std::remove (rowName.c_str ());
     }
-  std::cout << std::endl << "Missing HE TB PPDUs ratio: " << missingHeTbPpduRatio << std::endl;
-  std::cout << std::endl << "HE TB PPDU completeness: ("
-                         << m_minLengthRatio << ", "
-                         << m_maxLenghtRatio << ", "
-                         << m_avgLengthRatio << ")" << std::endl << std::endl;
-
-  m_appPacketTxMap.clear ();
-  m_appLatencyMap.clear ();
 
-  Simulator::Destroy ();
-  std::cout<<"---Exiting Run()---\n";
+  std::cout << std::endl << "Completed points = " << nCompleted << std::endl
+            << "Failed points = " << nFailed << std::endl;
+  return nFailed;
 }
 
-void
-WifiDlOfdmaExample::StartAssociation (void)
+/**
+ * \brief Benchmark of WifiDlOfdmaExample against a stored baseline
+ *
+ * The benchmark runs the points of a parameter grid through WifiDlOfdmaSweep, with
+ * one worker by default to keep timings reproducible. The default grid is a small
+ * sweep of the number of stations, the channel width and the DL ack sequence that
+ * completes in minutes; the full grid (up to 1000 stations, every channel width and
+ * DL ack sequence, UDP and TCP) is only run on request. For each point, the wall
+ * clock time of the run, the events executed per second, the peak memory and the
+ * total throughput are compared against those stored in the baseline file. A point
+ * regresses if its wall clock time or its peak memory grows, or its events per
+ * second drop, by more than the respective threshold. A point is flagged if its
+ * total throughput changes by more than the given threshold, which means that the
+ * simulated behavior changed and the timings are not comparable. The benchmark
+ * fails if any point failed, regressed or was flagged.
+ *
+ * If the baseline file does not exist or an update is requested, the results of the
+ * benchmark are stored as the new baseline.
+ */
+class WifiDlOfdmaBenchmark
 {
-  std::cout<<"---\nEntering StartAssociation()---\n";
-  NS_LOG_FUNCTION (this << m_currentSta);
-  NS_ASSERT (m_currentSta < m_nStations);
+public:
+  /**
+   * Create a benchmark.
+   *
+   * \param baseline the file storing the baseline
+   * \param gridFile the file listing the parameter grids (empty for a built-in grid)
+   * \param fullGrid whether the built-in grid is the full grid rather than the default one
+   * \param threshold the maximum allowed relative slowdown
+   * \param eventsThreshold the maximum allowed relative drop of the events per second
+   * \param rssThreshold the maximum allowed relative growth of the peak memory
+   * \param throughputThreshold the relative change of the throughput above which a point is flagged
+   * \param update whether to store the results as the new baseline
+   * \param nJobs the number of concurrent workers
+   * \param outputDir the directory storing the results and the logs
+   */
+  WifiDlOfdmaBenchmark (std::string baseline, std::string gridFile, bool fullGrid, double threshold,
+                        double eventsThreshold, double rssThreshold, double throughputThreshold,
+                        bool update, uint32_t nJobs, std::string outputDir);
+  /**
+   * Run the benchmark.
+   *
+   * \param argc the number of options of the invocation
+   * \param argv the options of the invocation
+   * \return the number of points that failed or regressed
+   */
+  int Run (int argc, char *argv[]);
 
-  Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice> (m_staDevices.Get (m_currentSta));
-  NS_ASSERT (dev != 0);
-  dev->GetMac ()->SetSsid (m_ssid); // this will lead the station to associate with the AP
-  std::cout<<"---Exiting StartAssociation()---\n";
-}
+private:
+  /// Benchmark metrics of a point
+  struct Metrics
+  {
+    double wallTime;     ///< wall clock time of the run (seconds)
+    double eventsPerS;   ///< events executed per second
+    double peakRssKb;    ///< peak resident set size (KiB)
+    double throughput;   ///< total throughput (Mb/s)
+  };
+  /**
+   * Read the benchmark metrics of every point from the given table.
+   *
+   * \param table the name of a sweep results table or of a baseline
+   * \return the metrics of each point, indexed by the key of the point
+   */
+  static std::map<std::string, Metrics> ReadMetrics (const std::string& table);
 
-void
-WifiDlOfdmaExample::EstablishBaAgreement (Mac48Address bssid)
+  std::string m_baseline;   // file storing the baseline
+  std::string m_gridFile;   // file listing the parameter grids
+  bool m_fullGrid;          // run the full built-in grid rather than the default one
+  double m_threshold;       // maximum allowed relative slowdown
+  double m_eventsThreshold; // maximum allowed relative drop of the events per second
+  double m_rssThreshold;    // maximum allowed relative growth of the peak memory
+  double m_throughputThreshold; // relative change of the throughput above which a point is flagged
+  bool m_update;            // store the results as the new baseline
+  uint32_t m_nJobs;         // number of concurrent workers
+  std::string m_outputDir;  // directory storing results and logs
+};
+
+WifiDlOfdmaBenchmark::WifiDlOfdmaBenchmark (std::string baseline, std::string gridFile, bool fullGrid,
+                                            double threshold, double eventsThreshold, double rssThreshold,
+                                            double throughputThreshold, bool update, uint32_t nJobs,
+                                            std::string outputDir)
+  : m_baseline (baseline),
+    m_gridFile (gridFile),
+    m_fullGrid (fullGrid),
+    m_threshold (threshold),
+    m_eventsThreshold (eventsThreshold),
+    m_rssThreshold (rssThreshold),
+    m_throughputThreshold (throughputThreshold),
+    m_update (update),
+    m_nJobs (nJobs),
+    m_outputDir (outputDir)
 {
-  std::cout<<"\n------In EstablishBaAgreement------\n";
-  NS_LOG_FUNCTION (this << bssid << m_currentSta);
+}
 
-  // Now that the current station is associated with the AP, let's trigger the creation
-  // of an entry in the ARP cache (of both the AP and the STA) and the establishment of
-  // a Block Ack agreement between the AP and the STA (and viceversa). This is done by
-  // having the AP send 3 ICMP Echo Requests to the STA
-  Time pingDuration = MilliSeconds (125);
+std::map<std::string, WifiDlOfdmaBenchmark::Metrics>
+WifiDlOfdmaBenchmark::ReadMetrics (const std::string& table)
+{
+  std::map<std::string, Metrics> metrics;
+  std::ifstream file (table);
+  std::string line;
 
-  V4PingHelper ping (m_staInterfaces.GetAddress (m_currentSta));
-  ping.SetAttribute ("Interval", TimeValue (MilliSeconds (50)));
-  if (m_verbose)
+  // the first line is the header, the first (quoted) field of the other lines is the key
+  if (!std::getline (file, line))
     {
-      ping.SetAttribute ("Verbose", BooleanValue (true));
+      return metrics;
+    }
+  std::vector<std::string> names;
+  std::istringstream header (line);
+  std::string name;
+  while (std::getline (header, name, ','))
+    {
+      names.push_back (name);
     }
-  ApplicationContainer pingApps = ping.Install (m_apNodes);
-  pingApps.Stop (pingDuration);
 
-  // Install a client application on the current station. In case of TCP traffic,
-  // this will trigger the establishment of a TCP connection. The client application
-  // is initially quiet (i.e., it does not transmit packets -- this is achieved
-  // by setting the duration of the "On" interval to zero).
-  uint16_t offInterval = 10;  // milliseconds
+  while (std::getline (file, line))
+    {
+      std::size_t end = line.find ('"', 1);
+      if (line.size () == 0 || line[0] != '"' || end == std::string::npos)
+        {
+          continue;
+        }
+      std::map<std::string, double> values;
+      std::istringstream fields (line.substr (end + 2));
+      std::string field;
+      for (std::size_t i = 1; i < names.size () && std::getline (fields, field, ','); i++)
+        {
+          values[names[i]] = std::strtod (field.c_str (), nullptr);
+        }
+      Metrics& m = metrics[line.substr (1, end - 1)];
+      m.wallTime = values["runWallTimeS"];
+      m.eventsPerS = values["eventsPerS"];
+      m.peakRssKb = values["peakRssKb"];
+      m.throughput = (values.count ("totalThroughput") ? values["totalThroughput"] : values["throughput"]);
+    }
+  return metrics;
+}
 
+int
+WifiDlOfdmaBenchmark::Run (int argc, char *argv[])
+{
+  NS_ABORT_MSG_IF (mkdir (m_outputDir.c_str (), 0755) != 0 && errno != EEXIST,
+                   "Cannot create directory " << m_outputDir << ": " << std::strerror (errno));
 
-  if(m_currentSta%2){    //if the clients dont use bulksend (use on off) jaishreeram
-    // std::stringstream ss;
-    // ss << "ns3::ConstantRandomVariable[Constant=" << std::fixed << static_cast<double> (offInterval / 1000.) << "]";
+  std::string gridFile = m_gridFile;
+  if (gridFile.empty ())
+    {
+      gridFile = m_outputDir + "/grid.txt";
+      std::ofstream grid (gridFile, std::ios::trunc);
+      if (m_fullGrid)
+        {
+          grid << "nStations=10,50,200,1000 channelWidth=20,40,80,160 dlAckType=1,2,3 transport=Udp,Tcp"
+               << " assocBatchSize=20 staticArp=1" << std::endl;
+        }
+      else
+        {
+          grid << "nStations=10,40 channelWidth=20,80 dlAckType=1,3" << std::endl;
+        }
+    }
 
-    std::string socketType = (m_transport.compare ("Tcp") == 0 ? "ns3::TcpSocketFactory" : "ns3::UdpSocketFactory");
-    OnOffHelper client (socketType, Ipv4Address::GetAny ());
-    client.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
-    client.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
-    client.SetAttribute ("DataRate", DataRateValue (DataRate (m_dataRate * 1e6)));
-    client.SetAttribute ("PacketSize", UintegerValue (m_payloadSize));    //jaishreeram for on off changing it to 160bytes to sim voice calls
+  // every benchmark run starts from scratch
+  std::string tableName = m_outputDir + "/results.csv";
+  std::remove (tableName.c_str ());
 
-    InetSocketAddress dest (m_staInterfaces.GetAddress (m_currentSta), m_port);
-    // dest.SetTos (0xb8); //AC_VI
-    client.SetAttribute ("Remote", AddressValue (dest));
+  // workers are passed the options of the invocation, except the benchmark itself
+  std::vector<std::string> args (argv, argv + argc);
+  args.push_back ("--benchmark=");
+  std::vector<char *> sweepArgv;
+  for (auto& arg : args)
+    {
+      sweepArgv.push_back (&arg[0]);
+    }
+  sweepArgv.push_back (nullptr);
 
-    // Make sure that the client application is started at a time that is an integer
-    // multiple of the offInterval. In fact, the client application will wake every
-    // offInterval milliseconds to check if a packet can be sent. Given that the duration
-    // of the "On" interval will be modified for all the client applications
-    // simultaneously, this ensures that all the client applications will actually
-    // start sending packets at the same time.
-    uint64_t startTime = std::ceil (Simulator::Now ().ToDouble (Time::MS) / offInterval) * offInterval;
-    std::cout<<"The Scheduled delay for this OnOff Client is "<<((static_cast<uint64_t> (startTime) + 110) - Simulator::Now ().ToDouble (Time::MS))<<"ms"<<"\n";
-    std::cout<<"Current time is "<<(Simulator::Now().ToDouble (Time::MS))<<"ms"<<"\n";
-    Simulator::Schedule (MilliSeconds (static_cast<uint64_t> (startTime) + 110) - Simulator::Now (),
-                        &WifiDlOfdmaExample::StartOnOffClient, this, client);  //jaishreeram changed it to StartOnOffClient
-    std::cout<<"Current Station: "<<m_currentSta<<" (OnOff Client)"<<std::endl; 
-  }
+  WifiDlOfdmaSweep sweep (gridFile, m_nJobs, m_outputDir);
+  int nFailed = sweep.Run (args.size (), sweepArgv.data ());
 
-  else{     //if the clients use bulksend jaishreeram
-  //   std::stringstream ss;
-  // ss << "ns3::ConstantRandomVariable[Constant=" << std::fixed << static_cast<double> (offInterval / 1000.) << "]";
+  std::map<std::string, Metrics> results = ReadMetrics (tableName);
+  std::map<std::string, Metrics> baseline = ReadMetrics (m_baseline);
+  int nRegressions = 0;
+  int nFlagged = 0;
 
-  // std::string socketType = (m_transport.compare ("Tcp") == 0 ? "ns3::TcpSocketFactory" : "ns3::UdpSocketFactory");
-    BulkSendHelper client ("ns3::TcpSocketFactory", Ipv4Address::GetAny ());
-    client.SetAttribute ("SendSize", UintegerValue(2048));
-    client.SetAttribute ("MaxBytes", UintegerValue(10240000)); 
-    InetSocketAddress dest (m_staInterfaces.GetAddress (m_currentSta), m_port_bulk);
-    client.SetAttribute ("Remote", AddressValue (dest));
+  std::cout << std::endl << "Benchmark (wall time s, events/s, peak MiB, throughput Mbps) vs baseline" << std::endl
+            << "------------------------------------------------------------------------" << std::endl;
+  for (auto& point : results)
+    {
+      const Metrics& m = point.second;
+      std::cout << "[" << point.first << "] (" << m.wallTime << ", " << m.eventsPerS << ", "
+                << m.peakRssKb / 1024 << ", " << m.throughput << ")";
+      auto it = baseline.find (point.first);
+      if (it == baseline.end () || it->second.wallTime <= 0)
+        {
+          std::cout << " no baseline" << std::endl;
+          continue;
+        }
+      const Metrics& b = it->second;
+      double slowdown = m.wallTime / b.wallTime - 1;
+      double eventsDrop = (b.eventsPerS > 0 ? 1 - m.eventsPerS / b.eventsPerS : 0.0);
+      double rssGrowth = (b.peakRssKb > 0 ? m.peakRssKb / b.peakRssKb - 1 : 0.0);
+      double tputChange = (b.throughput > 0 ? m.throughput / b.throughput - 1
+                                            : (m.throughput > 0 ? 1.0 : 0.0));
+      std::cout << " vs (" << b.wallTime << ", " << b.eventsPerS << ", "
+                << b.peakRssKb / 1024 << ", " << b.throughput << "): " << std::showpos
+                << slowdown * 100 << "% wall time, " << -eventsDrop * 100 << "% events/s, "
+                << rssGrowth * 100 << "% peak memory, " << tputChange * 100 << "% throughput"
+                << std::noshowpos;
+      bool regression = false;
+      if (slowdown > m_threshold)
+        {
+          regression = true;
+          std::cout << " SLOWER";
+        }
+      if (eventsDrop > m_eventsThreshold)
+        {
+          regression = true;
+          std::cout << " FEWER-EVENTS/S";
+        }
+      if (rssGrowth > m_rssThreshold)
+        {
+          regression = true;
+          std::cout << " MORE-MEMORY";
+        }
+      if (regression)
+        {
+          nRegressions++;
+          std::cout << " REGRESSION";
+        }
+      if (std::abs (tputChange) > m_throughputThreshold)
+        {
+          nFlagged++;
+          std::cout << " THROUGHPUT-CHANGED";
+        }
+      std::cout << std::endl;
+    }
+  std::cout << std::endl << "Failed points = " << nFailed << std::endl
+            << "Regressions (wall time " << m_threshold * 100 << "%, events/s " << m_eventsThreshold * 100
+            << "%, peak memory " << m_rssThreshold * 100 << "%) = " << nRegressions << std::endl
+            << "Throughput changes (threshold " << m_throughputThreshold * 100 << "%) = " << nFlagged << std::endl;
 
-    // InetSocketAddress dest (m_staInterfaces.GetAddress (m_currentSta), m_port);
-    // dest.SetTos (0xb8); //AC_VI
-    // client.SetAttribute ("Remote", AddressValue (dest));
-    std::cout<<"The Scheduled delay for this bulksend client is: "<<(47)<<"ms"<<"\n";
-    std::cout<<"Current time is "<<(Simulator::Now().ToDouble (Time::MS))<<"ms"<<"\n";
-    Simulator::Schedule (MilliSeconds (47), &WifiDlOfdmaExample::StartBulkSendClient, this, client); //jaishreeram
-    std::cout<<"Current Station: "<<m_currentSta<<" (Bulksend Client)"<<std::endl;  
-  }
-  // continue with the next station, if any is remaining
-    if (++m_currentSta < m_nStations)
-      {
-        Simulator::Schedule (pingDuration, &WifiDlOfdmaExample::StartAssociation, this);
-      }
-    else
-      {
-        Simulator::Schedule (pingDuration, &WifiDlOfdmaExample::StartTraffic, this);
-      }
-      // exit(0);
-      // std::cout<<"ba agree end\n";
+  if (m_update || baseline.empty ())
+    {
+      std::ofstream file (m_baseline, std::ios::trunc);
+      NS_ABORT_MSG_IF (!file.is_open (), "Cannot write baseline " << m_baseline);
+      file << std::setprecision (10) << "point,runWallTimeS,eventsPerS,peakRssKb,throughput" << std::endl;
+      for (auto& point : results)
+        {
+          file << "\"" << point.first << "\"," << point.second.wallTime << "," << point.second.eventsPerS
+               << "," << point.second.peakRssKb << "," << point.second.throughput << std::endl;
+        }
+      std::cout << "Baseline written to " << m_baseline << std::endl;
+    }
+  return nFailed + nRegressions + nFlagged;
 }
 
 
-void
-WifiDlOfdmaExample::StartBulkSendClient (BulkSendHelper client)   //jaishreeram added this function
-{
-  NS_LOG_FUNCTION (this << m_currentSta);
-  std::cout<<"Type of this client is: "<<typeid(client).name()<<std::endl;
-  m_clientApps_bulk.Add (client.Install (m_apNodes));
-  // m_clientApps_bulk.Stop (Seconds (m_warmup + m_simulationTime + 100)); // let clients be active for a long time jaishreeram commented
-}
-
-void
-WifiDlOfdmaExample::StartOnOffClient (OnOffHelper client)
+/**
+ * \brief Run independent replications of WifiDlOfdmaExample on a pool of worker processes
+ *
+ * Each replication is run by a forked worker process, which is passed the options
+ * of the invocation and a distinct RngRun value (the RngRun of the invocation plus
+ * the index of the replication). At most a given number of workers run at the same
+ * time. Every per-station and aggregate result of the completed replications is
+ * summarized by its mean and the half-width of its 95% confidence interval.
+ *
+ * No new replication is started once the confidence intervals of the total throughput
+ * and of the average latency are narrow enough (relative to the mean), provided that
+ * the minimum number of replications completed.
+ */
+class WifiDlOfdmaReplications
 {
-  NS_LOG_FUNCTION (this << m_currentSta);
-  std::cout<<"Type of this client is: "<<typeid(client).name()<<std::endl;
-  m_clientApps.Add (client.Install (m_apNodes));
-  // m_clientApps.Stop (Seconds (m_warmup + m_simulationTime + 100)); // let clients be active for a long time jaishreeram commented
-}
+public:
+  /**
+   * Create a replication manager.
+   *
+   * \param maxReplications the maximum number of replications
+   * \param minReplications the minimum number of replications before checking the precision
+   * \param targetPrecision the relative CI half-width at which replications stop (0 to run all of them)
+   * \param nJobs the maximum number of concurrent workers (0 means one per core)
+   * \param outputDir the directory storing the results table and the logs
+   */
+  WifiDlOfdmaReplications (uint32_t maxReplications, uint32_t minReplications, double targetPrecision,
+                           uint32_t nJobs, std::string outputDir);
+  /**
+   * Run the replications and report the summarized results.
+   *
+   * \param argc the number of options of the invocation
+   * \param argv the options of the invocation
+   * \return the number of replications that failed
+   */
+  int Run (int argc, char *argv[]);
 
+private:
+  /**
+   * Start a worker of the given pool to run the given replication.
+   *
+   * \param pool the pool of workers
+   * \param index the index of the replication
+   * \param baseArgs the options of the invocation
+   */
+  void StartReplication (WorkerPool& pool, uint32_t index, const std::vector<std::string>& baseArgs);
+  /**
+   * Add the results of the given replication to the samples of each result.
+   *
+   * \param index the index of the replication
+   * \return true if the results of the replication could be read
+   */
+  bool ReadReplication (uint32_t index);
+  /**
+   * \return true if the target precision has been reached
+   */
+  bool IsPrecisionReached (void) const;
+  /**
+   * Print the summarized aggregate results and write all the summarized results
+   * to the results table.
+   */
+  void Report (void) const;
+  /**
+   * \param index the index of a replication
+   * \param extension the extension of the file
+   * \return the name of the file in the output directory associated with the replication
+   */
+  std::string GetFileName (uint32_t index, std::string extension) const;
 
+  uint32_t m_maxReplications;   // maximum number of replications
+  uint32_t m_minReplications;   // minimum number of replications before checking the precision
+  double m_targetPrecision;     // relative CI half-width at which replications stop
+  uint32_t m_nJobs;             // maximum number of concurrent workers (0 means one per core)
+  std::string m_outputDir;      // directory storing results table and logs
+  uint32_t m_baseRun;           // RngRun of the first replication
+  std::vector<std::pair<std::string, std::vector<double> > > m_aggregateSamples;  // samples of each aggregate result
+  std::vector<std::pair<std::string, std::vector<std::vector<double> > > > m_staSamples;  // samples of each per-station result, by station
+};
 
-void
-WifiDlOfdmaExample::StartTraffic (void)
+WifiDlOfdmaReplications::WifiDlOfdmaReplications (uint32_t maxReplications, uint32_t minReplications,
+                                                  double targetPrecision, uint32_t nJobs, std::string outputDir)
+  : m_maxReplications (maxReplications),
+    m_minReplications (std::max<uint32_t> (minReplications, 2)),
+    m_targetPrecision (targetPrecision),
+    m_nJobs (nJobs),
+    m_outputDir (outputDir),
+    m_baseRun (RngSeedManager::GetRun ())
 {
-  NS_LOG_FUNCTION (this);
-
-  std::cout<<"\n---Entering in StartTraffic()---\n";
-  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
-    {
-      Ptr<Application> clientApp;
-      if(i%2==0){
-        clientApp= m_clientApps_bulk.Get (i/2);
-      }
-        
-      else {
-        clientApp= m_clientApps.Get(i/2);
-      }
-        
-      if(i%2==1){ //non bulk
-            std::cout<<"Starting Traffic for OnOffApplication [#"<<i<<"]"<<std::endl;
-            clientApp->SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
-            clientApp->SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
-        
-      }
-      else{ //bulk  jaishreeram
-        std::cout<<"Starting Traffic for BulkSendApplication [#"<<i<<"]"<<std::endl;
-        // clientApp->SetAttribute ("SendSize", UintegerValue(2048));    //jaishreeram commented
-        // clientApp->SetAttribute ("MaxBytes", UintegerValue(10240000));       
-      }
-    }
-
-  Simulator::Schedule (Seconds (m_warmup), &WifiDlOfdmaExample::StartStatistics, this);
-  std::cout<<"\n---Exiting StartTraffic()---\n";
 }
 
-void
-WifiDlOfdmaExample::StartStatistics (void)
+std::string
+WifiDlOfdmaReplications::GetFileName (uint32_t index, std::string extension) const
 {
-  NS_LOG_FUNCTION (this);
-  std::cout<<"\n---Entering StartStatistics()---\n";
-  Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice> (m_apDevices.Get (0));
-  PointerValue ptr;
-  dev->GetMac ()->GetAttribute ("BE_Txop", ptr);
-
-  // Trace TXOP duration for BE on the AP
-  ptr.Get<QosTxop> ()->TraceConnectWithoutContext ("TxopTrace", MakeCallback (&WifiDlOfdmaExample::TxopDuration, this));
-  // Trace expired MSDUs for BE on the AP
-  ptr.Get<QosTxop> ()->GetWifiMacQueue ()->TraceConnectWithoutContext ("Expired", MakeCallback (&WifiDlOfdmaExample::NotifyMsduExpired, this));
-  // Trace MSDUs dequeued from the BE EDCA queue on the AP
-  ptr.Get<QosTxop> ()->GetWifiMacQueue ()->TraceConnectWithoutContext ("Dequeue",
-                                                                       MakeCallback (&WifiDlOfdmaExample::NotifyMsduDequeuedFromEdcaQueue,
-                                                                                     this));
-  // Trace PSDUs forwarded down to the PHY on the AP
-  ptr.Get<QosTxop> ()->GetLow ()->TraceConnectWithoutContext ("ForwardDown", MakeCallback (&WifiDlOfdmaExample::NotifyPsduForwardedDown, this));
-  // Trace TX failures on the AP
-  DynamicCast<RegularWifiMac> (dev->GetMac ())->TraceConnectWithoutContext ("TxErrHeader", MakeCallback (&WifiDlOfdmaExample::NotifyTxFailed, this));
-  // Retrieve the number of bytes received by each station until the end of the warmup period
-  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
-    {
-      if(i%2)
-      m_rxStart[i] = DynamicCast<PacketSink> (m_sinkApps.Get (i/2))->GetTotalRx ();
-      else m_rxStart[i] = DynamicCast<PacketSink> (m_sinkApps_bulk.Get (i/2))->GetTotalRx ();
-    }
+  std::ostringstream oss;
+  oss << m_outputDir << "/replication-" << std::setfill ('0') << std::setw (5) << index << extension;
+  return oss.str ();
+}
 
-  // Trace PSDUs forwarded down to the PHY on each station
-  for (uint32_t i = 0; i < m_staDevices.GetN (); i++)
+void
+WifiDlOfdmaReplications::StartReplication (WorkerPool& pool, uint32_t index, const std::vector<std::string>& baseArgs)
+{
+  if (!pool.Spawn (index, GetFileName (index, ".log")))
     {
-      dev = DynamicCast<WifiNetDevice> (m_staDevices.Get (i));
-      dev->GetMac ()->GetAttribute ("BE_Txop", ptr);
-      ptr.Get<QosTxop> ()->GetLow ()->TraceConnectWithoutContext ("ForwardDown",
-                                                                  MakeCallback (&WifiDlOfdmaExample::NotifyPsduForwardedDown, this));
+      return;
     }
 
-  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::WifiMac/MacTx", MakeCallback (&WifiDlOfdmaExample::NotifyApplicationTx, this));
-  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::WifiMac/MacRx", MakeCallback (&WifiDlOfdmaExample::NotifyApplicationRx, this));
+  // Worker process: each replication uses its own run number
+  std::vector<std::string> args (baseArgs);
+  std::ostringstream rngRun;
+  rngRun << "--RngRun=" << m_baseRun + index;
+  args.push_back (rngRun.str ());
+  WifiDlOfdmaExample example;
+  RunExampleWorker (example, args, GetFileName (index, ""));
 
-  Simulator::Schedule (Seconds (m_simulationTime), &WifiDlOfdmaExample::StopStatistics, this);
-  std::cout<<"\n---Exiting StartStatistics()---\n";
+  // one result per line: the name, followed by the value of each station for per-station results
+  std::ofstream results (GetFileName (index, ".res"));
+  results << std::setprecision (17);
+  for (auto& result : example.GetAggregateResults ())
+    {
+      results << "aggregate " << result.first << " " << result.second << '\n';
+    }
+  for (auto& result : example.GetStaResults ())
+    {
+      results << "sta " << result.first;
+      for (double value : result.second)
+        {
+          results << " " << value;
+        }
+      results << '\n';
+    }
+  results.close ();
+  WorkerPool::Exit (!results.fail ());
 }
 
-void
-WifiDlOfdmaExample::StopStatistics (void)
+bool
+WifiDlOfdmaReplications::ReadReplication (uint32_t index)
 {
-  NS_LOG_FUNCTION (this);
-  std::cout<<"\n---Entering StopStatistics()---\n";
-  Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice> (m_apDevices.Get (0));
-  PointerValue ptr;
-  dev->GetMac ()->GetAttribute ("BE_Txop", ptr);
+  std::ifstream file (GetFileName (index, ".res"));
+  std::vector<std::pair<std::string, double> > aggregates;
+  std::vector<std::pair<std::string, std::vector<double> > > staResults;
+  std::string line;
 
-  // Stop tracing TXOP duration for BE on the AP
-  ptr.Get<QosTxop> ()->TraceDisconnectWithoutContext ("TxopTrace", MakeCallback (&WifiDlOfdmaExample::TxopDuration, this));
-  // Stop tracing expired MSDUs for BE on the AP
-  ptr.Get<QosTxop> ()->GetWifiMacQueue ()->TraceDisconnectWithoutContext ("Expired", MakeCallback (&WifiDlOfdmaExample::NotifyMsduExpired, this));
-  // Stop tracing MSDUs dequeued from the BE EDCA queue on the AP
-  ptr.Get<QosTxop> ()->GetWifiMacQueue ()->TraceDisconnectWithoutContext ("Dequeue",
-                                                                          MakeCallback (&WifiDlOfdmaExample::NotifyMsduDequeuedFromEdcaQueue,
-                                                                                        this));
-  // Stop tracing PSDUs forwarded down to the PHY on the AP
-  ptr.Get<QosTxop> ()->GetLow ()->TraceDisconnectWithoutContext ("ForwardDown", MakeCallback (&WifiDlOfdmaExample::NotifyPsduForwardedDown, this));
-  // Stop tracing TX failures on the AP
-  DynamicCast<RegularWifiMac> (dev->GetMac ())->TraceDisconnectWithoutContext ("TxErrHeader", MakeCallback (&WifiDlOfdmaExample::NotifyTxFailed, this));
-  // Retrieve the number of bytes received by each station until the end of the simulation period
-  // std::cout<<"I have reached here 0\n";
-  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+  while (std::getline (file, line))
     {
-      if(i%2)
-      // std::cout<<"I have reached here\n";
-        m_rxStop[i] = DynamicCast<PacketSink> (m_sinkApps.Get (i/2))->GetTotalRx ();
-        // std::cout<<"I exit from here\n";
-      else m_rxStop[i] = DynamicCast<PacketSink> (m_sinkApps_bulk.Get (i/2))->GetTotalRx ();
+      std::istringstream iss (line);
+      std::string type, name;
+      double value;
+      iss >> type >> name;
+      if (type == "aggregate" && iss >> value)
+        {
+          aggregates.push_back (std::make_pair (name, value));
+        }
+      else if (type == "sta")
+        {
+          staResults.push_back (std::make_pair (name, std::vector<double> ()));
+          while (iss >> value)
+            {
+              staResults.back ().second.push_back (value);
+            }
+        }
     }
-    // std::cout<<"I have reached here 1 \n";
-
-  // (Brutally) stop client applications
-  for (uint32_t i = 0; i < m_staNodes.GetN (); i++)
+  if (aggregates.empty ())
     {
-      std::cout<<"Brutally stopping station #"<<i<<"\n";
-      if(i%2==0)
-        m_clientApps_bulk.Get (i/2)->Dispose ();
-      else m_clientApps.Get (i/2)->Dispose ();
+      return false;
     }
-    // std::cout<<"I have reached here 2 \n";
 
-  // Stop tracing PSDUs forwarded down to the PHY on each station
-  for (uint32_t i = 0; i < m_staDevices.GetN (); i++)
+  // all the replications report the same results, in the same order
+  if (m_aggregateSamples.empty ())
     {
-      
-      dev = DynamicCast<WifiNetDevice> (m_staDevices.Get (i));
-      dev->GetMac ()->GetAttribute ("BE_Txop", ptr);
-      ptr.Get<QosTxop> ()->GetLow ()->TraceDisconnectWithoutContext ("ForwardDown",
-                                                                     MakeCallback (&WifiDlOfdmaExample::NotifyPsduForwardedDown, this));
-      
+      for (auto& result : aggregates)
+        {
+          m_aggregateSamples.push_back (std::make_pair (result.first, std::vector<double> ()));
+        }
+      for (auto& result : staResults)
+        {
+          m_staSamples.push_back (std::make_pair (result.first,
+                                                  std::vector<std::vector<double> > (result.second.size ())));
+        }
     }
-  // std::cout<<"I have reached here 3 \n";
-  Config::Disconnect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::WifiMac/MacTx", MakeCallback (&WifiDlOfdmaExample::NotifyApplicationTx, this));
-  Config::Disconnect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::WifiMac/MacRx", MakeCallback (&WifiDlOfdmaExample::NotifyApplicationRx, this));
-  std::cout<<"\n---Exiting StopStatistics()---\n";
+  if (aggregates.size () != m_aggregateSamples.size () || staResults.size () != m_staSamples.size ())
+    {
+      return false;
+    }
+  for (std::size_t k = 0; k < aggregates.size (); k++)
+    {
+      m_aggregateSamples[k].second.push_back (aggregates[k].second);
+    }
+  for (std::size_t k = 0; k < staResults.size (); k++)
+    {
+      std::vector<std::vector<double> >& stations = m_staSamples[k].second;
+      for (std::size_t i = 0; i < std::min (stations.size (), staResults[k].second.size ()); i++)
+        {
+          stations[i].push_back (staResults[k].second[i]);
+        }
+    }
+  return true;
 }
 
-void
-WifiDlOfdmaExample::NotifyTxFailed (const WifiMacHeader& hdr)
+bool
+WifiDlOfdmaReplications::IsPrecisionReached (void) const
 {
-  auto it = m_dlStats.find (hdr.GetAddr1 ());
-  NS_ASSERT (it != m_dlStats.end ());
-  it->second.failed++;
+  if (m_targetPrecision <= 0 || m_aggregateSamples.empty ()
+      || m_aggregateSamples.front ().second.size () < m_minReplications)
+    {
+      return false;
+    }
+  for (auto& result : m_aggregateSamples)
+    {
+      if (result.first == "totalThroughputMbps" || result.first == "avgLatencyMs")
+        {
+          double mean, halfWidth;
+          GetConfidenceInterval (result.second, mean, halfWidth);
+          // a null average latency means that latency was not measured
+          if (mean > 0 && halfWidth / mean >= m_targetPrecision)
+            {
+              return false;
+            }
+        }
+    }
+  return true;
 }
 
 void
-WifiDlOfdmaExample::NotifyMsduExpired (Ptr<const WifiMacQueueItem> item)
+WifiDlOfdmaReplications::Report (void) const
 {
-  auto it = m_dlStats.find (item->GetHeader ().GetAddr1 ());
-  NS_ASSERT (it != m_dlStats.end ());
-  it->second.expired++;
+  std::string tableName = m_outputDir + "/replications.csv";
+  std::ofstream table (tableName, std::ios::trunc);
+  NS_ABORT_MSG_IF (!table.is_open (), "Cannot open results table " << tableName);
+  table << std::setprecision (10) << "metric,station,replications,mean,ciHalfWidth" << std::endl;
+
+  std::cout << std::endl << "(Mean, 95% CI half-width) over " << m_aggregateSamples.front ().second.size ()
+            << " replications" << std::endl
+            << "---------------------------------------------" << std::endl;
+  double mean, halfWidth;
+  for (auto& result : m_aggregateSamples)
+    {
+      GetConfidenceInterval (result.second, mean, halfWidth);
+      std::cout << result.first << ": (" << mean << ", " << halfWidth << ")" << std::endl;
+      table << result.first << ",," << result.second.size () << "," << mean << "," << halfWidth << std::endl;
+    }
+  for (auto& result : m_staSamples)
+    {
+      for (std::size_t i = 0; i < result.second.size (); i++)
+        {
+          GetConfidenceInterval (result.second[i], mean, halfWidth);
+          table << result.first << "," << i << "," << result.second[i].size () << "," << mean
+                << "," << halfWidth << std::endl;
+        }
+    }
+  std::cout << std::endl << "Summarized results written to " << tableName << std::endl;
 }
 
-void
-WifiDlOfdmaExample::NotifyMsduDequeuedFromEdcaQueue (Ptr<const WifiMacQueueItem> item)
+int
+WifiDlOfdmaReplications::Run (int argc, char *argv[])
 {
-  Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice> (m_apDevices.Get (0));
-  PointerValue ptr;
-  dev->GetMac ()->GetAttribute ("BE_Txop", ptr);
+  NS_ABORT_MSG_IF (mkdir (m_outputDir.c_str (), 0755) != 0 && errno != EEXIST,
+                   "Cannot create directory " << m_outputDir << ": " << std::strerror (errno));
 
-  if (Simulator::Now () > item->GetTimeStamp () + ptr.Get<QosTxop> ()->GetWifiMacQueue ()->GetMaxDelay ())
-    {
-      // the MSDU lifetime is higher than the max queue delay, hence the MSDU has been
-      // discarded. Do nothing in this case.
-      return;
-    }
+  // workers are passed the options of the invocation, except the replications themselves
+  std::vector<std::string> baseArgs (argv, argv + argc);
+  baseArgs.push_back ("--replications=0");
+  WorkerPool pool (m_nJobs);
 
-  if (m_lastTxTime.IsStrictlyPositive ())
+  std::cout << "Max replications = " << m_maxReplications << std::endl
+            << "First RngRun = " << m_baseRun << std::endl
+            << "Workers = " << pool.GetNJobs () << std::endl << std::endl;
+
+  uint32_t next = 0;
+  int nFailed = 0;
+  bool precisionReached = false;
+
+  while (true)
     {
-      double newHolSample = (Simulator::Now () - m_lastTxTime).ToDouble (Time::MS);
+      if (next < m_maxReplications && !precisionReached && pool.CanSpawn ())
+        {
+          StartReplication (pool, next, baseArgs);
+          next++;
+          continue;
+        }
+      if (pool.IsIdle ())
+        {
+          break;
+        }
 
-      // if this is an MSDU that has been dequeued to be aggregated to a previously
-      // dequeued MSDU, the HoL sample will be null. Do not count null HoL samples
-      if (newHolSample > 0.0)
+      std::size_t job;
+      bool success = pool.Reap (job);
+      uint32_t index = job;
+
+      if (success && ReadReplication (index))
         {
-          if (m_minHolDelay == 0.0 || newHolSample < m_minHolDelay)
-            {
-              m_minHolDelay = newHolSample;
-            }
-          if (newHolSample > m_maxHolDelay)
-            {
-              m_maxHolDelay = newHolSample;
-            }
-          m_avgHolDelay = (m_avgHolDelay * m_nHolDelaySamples + newHolSample) / (m_nHolDelaySamples + 1);
-          m_nHolDelaySamples++;
+          std::cout << "Completed replication " << index << " (RngRun=" << m_baseRun + index << ")" << std::endl;
+        }
+      else
+        {
+          nFailed++;
+          std::cout << "FAILED replication " << index << ", see " << GetFileName (index, ".log") << std::endl;
+        }
+      std::remove (GetFileName (index, ".res").c_str ());
+
+      if (!precisionReached && IsPrecisionReached ())
+        {
+          // replications that are already running are completed and taken into account
+          precisionReached = true;
+          std::cout << "Target precision reached" << std::endl;
         }
     }
-  m_lastTxTime = Simulator::Now ();
 
-  auto it = m_dlStats.find (item->GetHeader ().GetAddr1 ());
-  NS_ASSERT (it != m_dlStats.end ());
+  if (!m_aggregateSamples.empty ())
+    {
+      Report ();
+    }
+  return nFailed;
+}
+
+
+/**
+ * \brief Offline recomputation of the statistics of a run from its binary trace
+ *
+ * The reader recomputes the per-station DL and UL statistics printed by
+ * WifiDlOfdmaExample::Run from the binary trace of the measurement period (see
+ * the traceFile option), without running the simulation again. ProcessPpdu and
+ * ProcessRecord, which are passed every PPDU and every other event of the trace,
+ * respectively, feed the same WifiDlOfdmaStats the simulation updates, hence new
+ * statistics are added to WifiDlOfdmaStats.
+ */
+class WifiDlOfdmaTraceReader
+{
+public:
+  /**
+   * Create a reader.
+   *
+   * \param fileName the name of the trace file
+   */
+  WifiDlOfdmaTraceReader (std::string fileName);
+  /**
+   * Read the trace and print the statistics.
+   *
+   * \return zero if the trace was read successfully
+   */
+  int Run (void);
+
+private:
+  /**
+   * Update the statistics with the records of the last PPDU.
+   */
+  void ProcessPpdu (void);
+  /**
+   * Update the statistics with the given record, which is not related to a PPDU.
+   *
+   * \param record the record
+   */
+  void ProcessRecord (const TraceRecord& record);
+  /**
+   * Print the statistics.
+   *
+   * \param os the output stream
+   */
+  void Print (std::ostream& os) const;
+
+  std::string m_fileName;            // name of the trace file
+  TraceHeader m_header;              // header of the trace
+  std::vector<TraceRecord> m_ppdu;   // records of the last PPDU
+  WifiDlOfdmaStats m_stats;          // statistics computed from the trace
+  uint64_t m_nRecords;               // number of records read
+};
+
+WifiDlOfdmaTraceReader::WifiDlOfdmaTraceReader (std::string fileName)
+  : m_fileName (fileName),
+    m_nRecords (0)
+{
+}
 
-  if (it->second.lastTxTime.IsStrictlyPositive ())
+int
+WifiDlOfdmaTraceReader::Run (void)
+{
+  std::FILE *file = std::fopen (m_fileName.c_str (), "rb");
+  if (file == nullptr)
     {
-      double newHolSample = (Simulator::Now () - it->second.lastTxTime).ToDouble (Time::MS);
+      std::cerr << "Cannot open trace file " << m_fileName << ": " << std::strerror (errno) << std::endl;
+      return EXIT_FAILURE;
+    }
+  if (std::fread (&m_header, sizeof (m_header), 1, file) != 1
+      || std::strncmp (m_header.magic, "WDOT", 4) != 0 || m_header.version != TRACE_VERSION)
+    {
+      std::cerr << m_fileName << " is not a trace of this version of the example" << std::endl;
+      std::fclose (file);
+      return EXIT_FAILURE;
+    }
+  m_stats.Reset (m_header.nStations);
 
-      // if this is an MSDU that has been dequeued to be aggregated to a previously
-      // dequeued MSDU, the HoL sample will be null. Do not count null HoL samples
-      if (newHolSample > 0.0)
+  std::vector<TraceRecord> records (8192);
+  std::size_t nRead;
+  while ((nRead = std::fread (records.data (), sizeof (TraceRecord), records.size (), file)) > 0)
+    {
+      for (std::size_t i = 0; i < nRead; i++)
         {
-          if (it->second.minHolDelay == 0.0 || newHolSample < it->second.minHolDelay)
+          const TraceRecord& record = records[i];
+          if (!m_ppdu.empty () && ((record.type != TraceRecord::PSDU && record.type != TraceRecord::TF_USER)
+                                   || record.ppdu != m_ppdu.front ().ppdu))
+            {
+              ProcessPpdu ();
+            }
+          if (record.type == TraceRecord::PSDU || record.type == TraceRecord::TF_USER)
             {
-              it->second.minHolDelay = newHolSample;
+              m_ppdu.push_back (record);
             }
-          if (newHolSample > it->second.maxHolDelay)
+          else
             {
-              it->second.maxHolDelay = newHolSample;
+              ProcessRecord (record);
             }
-          it->second.avgHolDelay = (it->second.avgHolDelay * it->second.nHolDelaySamples + newHolSample) / (it->second.nHolDelaySamples + 1);
-          it->second.nHolDelaySamples++;
         }
+      m_nRecords += nRead;
+    }
+  if (!m_ppdu.empty ())
+    {
+      ProcessPpdu ();
     }
-  it->second.lastTxTime = Simulator::Now ();
+  std::fclose (file);
+
+  std::cout << "Trace " << m_fileName << ": " << m_nRecords << " records, " << m_header.nStations
+            << " stations" << std::endl;
+  Print (std::cout);
+  return EXIT_SUCCESS;
 }
 
 void
-WifiDlOfdmaExample::NotifyPsduForwardedDown (WifiPsduMap psduMap, WifiTxVector txVector)
+WifiDlOfdmaTraceReader::ProcessPpdu (void)
 {
-  Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice> (m_apDevices.Get (0));
-  Mac48Address apAddress = dev->GetMac ()->GetAddress ();
+  const TraceRecord& first = m_ppdu.front ();
 
-  if (psduMap.size () == 1 && psduMap.begin ()->second->GetAddr1 () == apAddress
-      && psduMap.begin ()->second->GetHeader (0).IsQosData ())
+  if (first.kind == TraceRecord::QOS_DATA && first.uplink)
     {
       // Uplink frame
-      if (txVector.GetPreambleType () == WIFI_PREAMBLE_HE_TB)
+      if (first.preamble == WIFI_PREAMBLE_HE_TB)
         {
           // HE TB PPDU
-          auto it = m_ulStats.find (psduMap.begin ()->second->GetAddr2 ());
-          NS_ASSERT (it != m_ulStats.end ());
-          Time txDuration = WifiPhy::CalculateTxDuration (psduMap, txVector, m_channelCenterFrequency);
-          m_responsesToLastTfDuration += txDuration;
-          double currRatio = txDuration.GetSeconds () / m_tfUlLength.GetSeconds ();
-
-          if (it->second.minLengthRatio == 0 || currRatio < it->second.minLengthRatio)
-            {
-              it->second.minLengthRatio = currRatio;
-            }
-          if (currRatio > it->second.maxLenghtRatio)
-            {
-              it->second.maxLenghtRatio = currRatio;
-            }
-          it->second.avgLengthRatio = (it->second.avgLengthRatio * it->second.nLengthRatioSamples + currRatio)
-                                      / (it->second.nLengthRatioSamples + 1);
-          it->second.nLengthRatioSamples++;
+          m_stats.NotifyHeTbPpdu (first.sta, NanoSeconds (first.value));
         }
     }
   // Downlink frame
-  else if (psduMap.begin ()->second->GetHeader (0).IsQosData ())
+  else if (first.kind == TraceRecord::QOS_DATA)
     {
-      uint32_t maxAmpduSize = 0;
-      uint32_t ampduSizeSum = 0;
-
-      for (auto& psdu : psduMap)
+      std::vector<std::pair<std::size_t, uint32_t> > users;
+      for (auto& record : m_ppdu)
         {
-          uint32_t currSize = psdu.second->GetSize ();
-          if (currSize > maxAmpduSize)
-            {
-              maxAmpduSize = currSize;
-            }
-          ampduSizeSum += currSize;
-
-          auto it = m_dlStats.find (psdu.second->GetAddr1 ());
-          NS_ASSERT (it != m_dlStats.end ());
-          if (it->second.minAmpduSize == 0 || currSize < it->second.minAmpduSize)
-            {
-              it->second.minAmpduSize = currSize;
-            }
-          if (currSize > it->second.maxAmpduSize)
+          if (record.size > 0)
             {
-              it->second.maxAmpduSize = currSize;
+              m_stats.NotifyDlPsdu (record.sta, record.size);
             }
-          it->second.nAmpdus++;
+          // RUs assigned to stations that were not sent a PSDU have a null size
+          users.push_back (std::make_pair (record.sta, record.size));
         }
 
       // DL MU PPDU
-      if (txVector.GetPreambleType () == WIFI_PREAMBLE_HE_MU)
+      if (first.preamble == WIFI_PREAMBLE_HE_MU)
         {
-          std::size_t nRus = txVector.GetHeMuUserInfoMap ().size ();
-          uint32_t maxBytes = maxAmpduSize * nRus;
-          NS_ASSERT (maxBytes > 0);
-          double currRatio = static_cast<double> (ampduSizeSum) / maxBytes;
-
-          if (m_minAmpduRatio == 0 || currRatio < m_minAmpduRatio)
-            {
-              m_minAmpduRatio = currRatio;
-            }
-          if (currRatio > m_maxAmpduRatio)
-            {
-              m_maxAmpduRatio = currRatio;
-            }
-          m_avgAmpduRatio = (m_avgAmpduRatio * m_nAmpduRatioSamples + currRatio) / (m_nAmpduRatioSamples + 1);
-          m_nAmpduRatioSamples++;
-
-          dev = DynamicCast<WifiNetDevice> (m_apDevices.Get (0));
-          Ptr<ApWifiMac> mac = DynamicCast<ApWifiMac> (dev->GetMac ());
-
-          for (auto& userInfo : txVector.GetHeMuUserInfoMap ())
-            {
-              auto psduIt = psduMap.find (userInfo.first);
-
-              if (psduIt == psduMap.end ())
-                {
-                  // the station that was assigned this RU did not transmit a PSDU
-                  currRatio = 0.0;
-                }
-              else
-                {
-                  currRatio = static_cast<double> (psduIt->second->GetSize ()) / maxAmpduSize;
-                }
-
-              Mac48Address address = mac->GetStaList ().at (userInfo.first);
-              auto it = m_dlStats.find (address);
-              NS_ASSERT (it != m_dlStats.end ());
-
-              if (it->second.minAmpduRatio == 0 || currRatio < it->second.minAmpduRatio)
-                {
-                  it->second.minAmpduRatio = currRatio;
-                }
-              if (currRatio > it->second.maxAmpduRatio)
-                {
-                  it->second.maxAmpduRatio = currRatio;
-                }
-              it->second.avgAmpduRatio = (it->second.avgAmpduRatio * it->second.nAmpduRatioSamples + currRatio)
-                                         / (it->second.nAmpduRatioSamples + 1);
-              it->second.nAmpduRatioSamples++;
-            }
+          m_stats.NotifyDlMuPpdu (users);
         }
     }
-  else if (psduMap.size () == 1 && psduMap.begin ()->second->GetHeader (0).IsTrigger ())
+  else if (first.kind == TraceRecord::BASIC_TF)
     {
-      CtrlTriggerHeader trigger;
-      psduMap.begin ()->second->GetPayload (0)->PeekHeader (trigger);
-
-      if (trigger.IsBasic ())
+      // the Basic Trigger Frame is followed by the records of the solicited stations
+      Time ulLength;
+      std::size_t nUsers = 0;
+      for (auto& record : m_ppdu)
         {
-          if (m_tfUlLength.IsStrictlyPositive ())
+          if (record.type == TraceRecord::TF_USER)
             {
-              // This is not the first Trigger Frame being sent
-              if (m_responsesToLastTfDuration.IsZero ())
-                {
-                  // no station responded to the previous TF
-                  m_nFailedTriggerFrames++;
-                }
-              else
-                {
-                  double currRatio = m_responsesToLastTfDuration.GetSeconds () / m_overallTimeGrantedByTf.GetSeconds ();
-
-                  if (m_minLengthRatio == 0 || currRatio < m_minLengthRatio)
-                    {
-                      m_minLengthRatio = currRatio;
-                    }
-                  if (currRatio > m_maxLenghtRatio)
-                    {
-                      m_maxLenghtRatio = currRatio;
-                    }
-                  uint64_t samples = m_nBasicTriggerFramesSent - 1 - m_nFailedTriggerFrames;
-                  m_avgLengthRatio = (m_avgLengthRatio * samples + currRatio) / (samples + 1);
-                }
+              ulLength = NanoSeconds (record.value);
+              nUsers = record.size;
             }
-
-          m_nBasicTriggerFramesSent++;
-          m_responsesToLastTfDuration = Seconds (0);
-          WifiTxVector heTbTxVector = trigger.GetHeTbTxVector (trigger.begin ()->GetAid12 ());
-          m_tfUlLength = WifiPhy::ConvertLSigLengthToHeTbPpduDuration (trigger.GetUlLength (), heTbTxVector,
-                                                                       m_channelCenterFrequency);
-          m_overallTimeGrantedByTf = m_tfUlLength * trigger.GetNUserInfoFields ();
-
-          dev = DynamicCast<WifiNetDevice> (m_apDevices.Get (0));
-          Ptr<ApWifiMac> mac = DynamicCast<ApWifiMac> (dev->GetMac ());
-
-          for (auto& userInfo : trigger)
+        }
+      m_stats.NotifyBasicTf (ulLength, nUsers);
+      for (auto& record : m_ppdu)
+        {
+          if (record.type == TraceRecord::TF_USER)
             {
-              Mac48Address address = mac->GetStaList ().at (userInfo.GetAid12 ());
-              auto it = m_ulStats.find (address);
-              NS_ASSERT (it != m_ulStats.end ());
-              it->second.nSolicitingTriggerFrames++;
+              m_stats.NotifySolicitedSta (record.sta);
             }
         }
     }
+  m_ppdu.clear ();
 }
 
 void
-WifiDlOfdmaExample::TxopDuration (Time startTime, Time duration)
+WifiDlOfdmaTraceReader::ProcessRecord (const TraceRecord& record)
 {
-  if (duration > m_maxTxop)
+  switch (record.type)
     {
-      m_maxTxop = duration;
+    case TraceRecord::EXPIRED:
+      m_stats.NotifyMsduExpired (record.sta);
+      break;
+    case TraceRecord::TX_FAILED:
+      m_stats.NotifyTxFailed (record.sta);
+      break;
+    case TraceRecord::DEQUEUE:
+      m_stats.NotifyMsduDequeued (record.sta, NanoSeconds (record.value), NanoSeconds (m_header.maxDelay),
+                                  NanoSeconds (record.time));
+      break;
+    default:
+      break;
     }
 }
 
 void
-WifiDlOfdmaExample::NotifyApplicationTx (std::string context, Ptr<const Packet> p)
+WifiDlOfdmaTraceReader::Print (std::ostream& os) const
 {
-  if (p->GetSize () < m_payloadSize)
+  std::size_t nStations = m_stats.GetNStations ();
+  os << std::endl << "TX failures" << std::endl
+                  << "-----------" << std::endl;
+  for (std::size_t i = 0; i < nStations; i++)
     {
-      return;
+      os << "STA_" << i << ": " << m_stats.GetDlStats (i).failed << " ";
     }
-  m_appPacketTxMap.insert (std::make_pair (p->GetUid (), Simulator::Now ()));
-}
-
-void
-WifiDlOfdmaExample::NotifyApplicationRx (std::string context, Ptr<const Packet> p)
-{
-  if (p->GetSize () < m_payloadSize)
+  os << std::endl << std::endl << "Expired MSDUs" << std::endl
+                               << "-------------" << std::endl;
+  for (std::size_t i = 0; i < nStations; i++)
     {
-      return;
+      os << "STA_" << i << ": " << m_stats.GetDlStats (i).expired << " ";
     }
-  auto itTxPacket = m_appPacketTxMap.find (p->GetUid ());
-  if (itTxPacket != m_appPacketTxMap.end ())
+  os << std::endl << std::endl << "(Min,Max,Count) A-MPDU size" << std::endl
+                               << "---------------------------" << std::endl;
+  for (std::size_t i = 0; i < nStations; i++)
     {
-      Time latency = (Simulator::Now () - itTxPacket->second);
-      auto itStaLatencies = m_appLatencyMap.find (ContextToNodeId (context));
-      NS_ASSERT (itStaLatencies != m_appLatencyMap.end ());
-      itStaLatencies->second.push_back (latency);
-      m_appPacketTxMap.erase (itTxPacket);
+      const WifiDlOfdmaStats::DlStats& stats = m_stats.GetDlStats (i);
+      os << "STA_" << i << ": (" << stats.minAmpduSize << "," << stats.maxAmpduSize << "," << stats.nAmpdus << ") ";
     }
-}
+  os << std::endl << std::endl << "(Min,Max,Avg) A-MPDU size to max A-MPDU size in DL MU PPDU ratio" << std::endl
+                               << "----------------------------------------------------------------" << std::endl;
+  for (std::size_t i = 0; i < nStations; i++)
+    {
+      const WifiDlOfdmaStats::MinMaxAvg& ratio = m_stats.GetDlStats (i).ampduRatio;
+      os << std::fixed << std::setprecision (3)
+         << "STA_" << i << ": (" << ratio.min << ", " << ratio.max << ", " << ratio.avg << ") ";
+    }
+  const WifiDlOfdmaStats::MinMaxAvg& ampduRatio = m_stats.GetDlMuPpduCompleteness ();
+  os << std::endl << std::endl << "DL MU PPDU completeness: ("
+     << ampduRatio.min << ", " << ampduRatio.max << ", " << ampduRatio.avg << ")" << std::endl;
 
-uint32_t
-WifiDlOfdmaExample::ContextToNodeId (const std::string & context)
-{
-  std::string sub = context.substr (10);
-  uint32_t pos = sub.find ("/Device");
-  uint32_t nodeId = atoi (sub.substr (0, pos).c_str ());
-  return nodeId;
+  os << std::endl << "(Min,Max,Avg) Pairwise head-of-line delay (ms)" << std::endl
+                  << "----------------------------------------------" << std::endl;
+  for (std::size_t i = 0; i < nStations; i++)
+    {
+      const WifiDlOfdmaStats::MinMaxAvg& holDelay = m_stats.GetDlStats (i).holDelay;
+      os << "STA_" << i << ": (" << holDelay.min << ", " << holDelay.max << ", " << holDelay.avg << ") ";
+    }
+  const WifiDlOfdmaStats::MinMaxAvg& holDelay = m_stats.GetHolDelay ();
+  os << std::endl << std::endl << "Head-of-line delay (ms): ("
+     << holDelay.min << ", " << holDelay.max << ", " << holDelay.avg << ")" << std::endl;
+
+  os << std::endl << "Unresponded TFs ratio/(Min,Max,Avg) HE TB PPDU duration to UL Length ratio" << std::endl
+                  << "--------------------------------------------------------------------------" << std::endl;
+  for (std::size_t i = 0; i < nStations; i++)
+    {
+      const WifiDlOfdmaStats::UlStats& stats = m_stats.GetUlStats (i);
+      double unrespondedTfRatio = 0.0;
+      if (stats.nSolicitingTriggerFrames > 0)
+        {
+          unrespondedTfRatio = static_cast<double> (stats.nSolicitingTriggerFrames - stats.lengthRatio.count)
+                               / stats.nSolicitingTriggerFrames;
+        }
+      os << "STA_" << i << ": " << unrespondedTfRatio << "/(" << stats.lengthRatio.min
+                        << ", " << stats.lengthRatio.max << ", " << stats.lengthRatio.avg << ") ";
+    }
+  const WifiDlOfdmaStats::MinMaxAvg& lengthRatio = m_stats.GetHeTbPpduCompleteness ();
+  os << std::endl << std::endl << "(Failed, Sent) Basic Trigger Frames: ("
+     << m_stats.GetNFailedTriggerFrames () << ", " << m_stats.GetNBasicTriggerFramesSent () << ")" << std::endl;
+  os << std::endl << "HE TB PPDU completeness: ("
+     << lengthRatio.min << ", " << lengthRatio.max << ", " << lengthRatio.avg << ")" << std::endl;
 }
 
 int main (int argc, char *argv[])
@@ -1307,6 +8360,38 @@ int main (int argc, char *argv[])
   WifiDlOfdmaExample example;
   auto start = std::chrono::high_resolution_clock::now();
   example.Config (argc, argv);
+  if (!example.GetReadTrace ().empty ())
+    {
+      WifiDlOfdmaTraceReader reader (example.GetReadTrace ());
+      return reader.Run ();
+    }
+  if (!example.GetSweepFile ().empty ())
+    {
+      WifiDlOfdmaSweep sweep (example.GetSweepFile (), example.GetSweepJobs (), example.GetSweepOutput ());
+      return (sweep.Run (argc, argv) == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+  if (!example.GetBenchmark ().empty ())
+    {
+      WifiDlOfdmaBenchmark benchmark (example.GetBenchmark (), example.GetBenchmarkGrid (),
+                                      example.GetBenchmarkFullGrid (), example.GetBenchmarkThreshold (),
+                                      example.GetBenchmarkEventsThreshold (), example.GetBenchmarkRssThreshold (),
+                                      example.GetBenchmarkThroughputThreshold (), example.GetBenchmarkUpdate (),
+                                      example.GetBenchmarkJobs (), example.GetBenchmarkOutput ());
+      return (benchmark.Run (argc, argv) == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+  if (example.GetReplications () > 0)
+    {
+      WifiDlOfdmaReplications replications (example.GetReplications (), example.GetMinReplications (),
+                                            example.GetReplicationPrecision (), example.GetReplicationJobs (),
+                                            example.GetReplicationOutput ());
+      return (replications.Run (argc, argv) == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+  if (!example.GetScenarios ().empty ())
+    {
+      WifiDlOfdmaScenario scenario;
+      scenario.RunFile (example.GetScenarios (), example.GetScenarioOutput (), argc, argv);
+      return EXIT_SUCCESS;
+    }
   example.Setup ();
   example.Run ();
   auto stop = std::chrono::high_resolution_clock::now();